@@ -0,0 +1,74 @@
+#!/bin/bash
+
+## Use this script to see how feeding in blocks (parameter blocksize)
+## trades accuracy for speed. The program must have been compiled
+## already. For each block size, the same simulation is run and timed,
+## and the final ecological and spatial isolation are compared with
+## those of the exact model (block size of one). Optional arguments are
+## the population size, the number of threads and the block sizes to try,
+## e.g. ./dev/run_blocks.sh 10000000 8 "1 64 1024 16384".
+
+# Path to the bin folder
+BIN_DIR="./bin"
+
+# Path to the folder where to run the simulations
+BLOCKS_DIR="./blocks"
+
+# Settings (or defaults)
+POPSIZE=${1:-1000000}
+NTHREADS=${2:-4}
+SIZES=${3:-"1 16 256 4096 65536"}
+
+# Check if the bin directory exists
+if [ ! -d "$BIN_DIR" ]; then
+    echo "Error: Bin directory '$BIN_DIR' does not exist. Please compile the program first."
+    exit 1
+fi
+
+# Create the blocks directory if it doesn't exist
+mkdir -p "$BLOCKS_DIR"
+
+# Go there
+cd "$BLOCKS_DIR"
+
+# Header of the table
+printf "%10s %10s %12s %12s %12s %12s\n" "blocksize" "seconds" "EI" "SI" "dEI" "dSI"
+
+# For each block size...
+for B in $SIZES; do
+
+    # Create the parameters.txt file
+    PARAM_FILE="parameters.txt"
+    cat > "$PARAM_FILE" <<EOL
+popsize $POPSIZE
+nthreads $NTHREADS
+blocksize $B
+tend 20
+nrounds 10
+hsymmetry 0.5
+mutrate 0.01
+dispersal 0.01
+seed 42
+verbose 1
+EOL
+
+    # Run the program and time it
+    START=$(date +%s.%N)
+    OUTPUT=$(../$BIN_DIR/reschoice "$PARAM_FILE" | grep "^t = " | tail -n 1)
+    END=$(date +%s.%N)
+
+    # Read the final isolation statistics
+    EI=$(echo "$OUTPUT" | sed 's/.*EI = \([^,]*\),.*/\1/')
+    SI=$(echo "$OUTPUT" | sed 's/.*SI = \(.*\)$/\1/')
+
+    # Keep those of the exact model as reference (the first block size should be one)
+    if [ -z "$EI0" ]; then EI0=$EI; SI0=$SI; fi
+
+    # Print a row of the table
+    awk -v b="$B" -v s="$START" -v e="$END" -v ei="$EI" -v si="$SI" -v ei0="$EI0" -v si0="$SI0" \
+        'BEGIN { printf "%10s %10.2f %12.6f %12.6f %12.6f %12.6f\n", b, e - s, ei, si, ei - ei0, si - si0 }'
+
+done
+
+# Print a message indicating where the simulations were run
+echo "Done! Simulations were run in the '$BLOCKS_DIR' directory."
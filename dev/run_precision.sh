@@ -0,0 +1,102 @@
+#!/bin/bash
+
+## Use this script to check that storing individuals in single precision
+## (RESCHOICE_FLOAT, see doc/SETUP.md) does not change the course of the
+## simulations. The program is compiled in both precisions (in release mode,
+## the double precision version being left in bin/ at the end), the same
+## simulations are run with each, and the ecological and spatial isolation
+## trajectories are compared. For each seed, the table gives the largest
+## differences in EI and SI along the way and the final values in both
+## precisions. Because a single choice or birth turning out differently is
+## enough for the two simulations to part ways, the differences between
+## precisions should be compared with those between seeds, given in the last
+## two rows (mean and standard deviation of each column across seeds).
+## Optional arguments are the population size, the simulation time and the
+## seeds to try, e.g. ./dev/run_precision.sh 100000 200 "1 2 3".
+
+# Path to the bin folder
+BIN_DIR="./bin"
+
+# Path to the folder where to run the simulations
+PRECISION_DIR="./precision"
+
+# Settings (or defaults)
+POPSIZE=${1:-10000}
+TEND=${2:-100}
+SEEDS=${3:-"1 2 3 4 5"}
+
+# Create the precision directory if it doesn't exist
+mkdir -p "$PRECISION_DIR"
+
+# Compile in single and then double precision, keeping a copy of each
+for MODE in float double; do
+
+    # Compiler flags
+    if [ "$MODE" = "float" ]; then FLAGS="-DRESCHOICE_FLOAT"; else FLAGS=""; fi
+
+    # Build (removing the previous binary, as both builds put theirs in the same place)
+    rm -f "$BIN_DIR/reschoice"
+    cmake -S . -B "$PRECISION_DIR/build_$MODE" -DCMAKE_CXX_FLAGS="$FLAGS" > /dev/null && \
+    cmake --build "$PRECISION_DIR/build_$MODE" > /dev/null
+    if [ $? -ne 0 ]; then
+        echo "Error: Failed to compile in $MODE precision."
+        exit 1
+    fi
+
+    # Keep a copy
+    cp "$BIN_DIR/reschoice" "$PRECISION_DIR/reschoice_$MODE"
+
+done
+
+# Go there
+cd "$PRECISION_DIR"
+
+# Start a new table
+rm -f "table.txt"
+
+# Header of the table
+printf "%6s %12s %12s %12s %12s %12s %12s\n" "seed" "maxdEI" "maxdSI" "EI(double)" "EI(float)" "SI(double)" "SI(float)"
+
+# For each seed...
+for S in $SEEDS; do
+
+    # Create the parameters.txt file
+    PARAM_FILE="parameters.txt"
+    cat > "$PARAM_FILE" <<EOL
+popsize $POPSIZE
+tend $TEND
+nrounds 10
+hsymmetry 0.5
+mutrate 0.01
+dispersal 0.01
+seed $S
+verbose 1
+EOL
+
+    # Run the program in both precisions and keep the trajectories
+    for MODE in double float; do
+        ./reschoice_$MODE "$PARAM_FILE" | grep "^t = " | \
+            sed 's/.*EI = \([^,]*\), SI = \(.*\)$/\1 \2/' > "trajectory_${MODE}_$S.txt"
+    done
+
+    # Compare them
+    paste "trajectory_double_$S.txt" "trajectory_float_$S.txt" | awk -v s="$S" '
+        function abs(x) { return x < 0 ? -x : x }
+        { if (abs($1 - $3) > dei) dei = abs($1 - $3); if (abs($2 - $4) > dsi) dsi = abs($2 - $4); ei = $1; eif = $3; si = $2; sif = $4 }
+        END { printf "%6s %12.6f %12.6f %12.6f %12.6f %12.6f %12.6f\n", s, dei, dsi, ei, eif, si, sif }' | tee -a "table.txt"
+
+done
+
+# Summarize across seeds
+awk '
+    { for (k = 2; k <= 7; ++k) { sum[k] += $k; ssq[k] += $k * $k } ++n }
+    END {
+        printf "%6s", "mean"; for (k = 2; k <= 7; ++k) printf " %12.6f", sum[k] / n; printf "\n"
+        printf "%6s", "sdev"; for (k = 2; k <= 7; ++k) { v = ssq[k] / n - (sum[k] / n)^2; printf " %12.6f", sqrt(v > 0 ? v : 0) } printf "\n"
+    }' "table.txt"
+
+# Clean up
+rm "table.txt"
+
+# Print a message indicating where the simulations were run
+echo "Done! Simulations were run in the '$PRECISION_DIR' directory."
@@ -4,34 +4,6 @@
 
 #include "MAIN.hpp"
 
-// Function to return a list of valid outputs
-std::vector<std::string> valid() {
-
-    // Return a list of valid outputs
-    return {
-
-        "time",                                     // 0    time steps
-        "resourceCensus",                           // 1    number of individuals feeding on each resource at each feeding round in each habitat
-        "resourceMeanTraitValue",                   // 2    mean trait value of individuals feeding on each resource at each feeding round in each habitat
-        "individualExpectedFitnessDifference",      // 3    expected fitness difference between the resources for each individual at each feeding round
-        "individualChoice",                         // 4    resource choice made by each individual at each feeding round
-        "individualRealizedFitness",                // 5    realized fitness gain of each individual after each feeding round
-		"individualRank",                           // 6    position of each individual in the feeding queue at each feeding round
-        "individualHabitat",                        // 7    habitat of each individual
-        "individualTraitValue",                     // 8    trait value of each individual
-        "individualTotalFitness",                   // 9    total fitness of each individual after all feeding rounds
-        "individualEcotype",                        // 10   ecotype of each individual (relative to population average)
-		"habitatCensus",                            // 11   number of individuals in each habitat
-        "habitatMeanTraitValue",                    // 12   mean trait value in each habitat
-		"ecologicalIsolation",                      // 13   ecological isolation statistic
-        "spatialIsolation",                         // 14   spatial isolation statistic
-        "traitMean",                                // 15   trait mean in the population
-        "traitStandardDeviation"                    // 16   trait standard deviation in the population
-
-    };
-
-}
-
 // Simulation function
 void doMain(const std::vector<std::string> &args) {
 
@@ -60,7 +32,7 @@ void doMain(const std::vector<std::string> &args) {
     if (pars.savepars) pars.save("paramlog.txt");
 
 	// Create a printer
-    Printer print(valid(), pars.memsave);
+    Printer print(out::names(), pars.memsave, out::types(), pars.compress);
 
 	// If needed...
     if (pars.savedat && pars.choose) {
@@ -82,6 +54,14 @@ void doMain(const std::vector<std::string> &args) {
         // Verbose
         std::cout << "Output files open succesfully\n";
 
+    }
+
+	// Individual-level outputs do not exist when individuals are pooled into classes
+    if (pars.savedat && pars.cohorts) {
+        for (const std::string &name : out::names()) {
+            if (name.rfind("individual", 0u) == 0u && print.exists(name))
+                throw std::runtime_error("Output " + name + " cannot be saved with cohorts");
+        }
     }
 
 	// Create a population of individuals
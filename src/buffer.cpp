@@ -3,24 +3,44 @@
 #include "buffer.hpp"
 
 // Constructor
-Buffer::Buffer(const size_t &n, const std::string &name) :
+Buffer::Buffer(const size_t &n, const std::string &name, const prt::Type &kind, Writer *background, const bool &pack, const double &error) :
     filename(name),
-    maxsize(n),
-    head(std::make_unique<std::vector<double> >()),
-    tail(std::make_unique<std::vector<double> >()),
-    file(std::ofstream())
+    maxsize(kind == prt::bit ? (n + 7u) / 8u * 8u : n),
+    type(kind),
+    head(std::make_unique<std::vector<uint8_t> >()),
+    tail(std::make_unique<std::vector<uint8_t> >()),
+    count(0u),
+    file(std::ofstream()),
+    opened(false),
+    writer(background),
+    compress(pack),
+    bound(error)
 {
 
-    // n: size of the buffer
+    // n: size of the buffer (in number of values)
     // name: name of the ouput file 
+    // kind: type the values are written as
+    // background: writer to write to file in the background (none to write right away)
+    // pack: whether to compress what is written
+    // error: error bound to quantize values within (zero to keep them exact)
+
+    // Note: buffers of bits hold a whole number of bytes, so they are only ever
+    // flushed at the end of a byte (except when closing).
+
+    // Check that only doubles are quantized
+    assert(bound >= 0.0);
+    assert(bound == 0.0 || type == prt::f64);
+
+    // Number of bytes needed
+    const size_t nbytes = (maxsize * prt::bits(type) + 7u) / 8u;
 
     // Reserve space
-    head->reserve(maxsize);
-    tail->reserve(maxsize);
+    head->reserve(nbytes);
+    tail->reserve(nbytes);
 
     // Check that the containers have reserved space
-    assert(head->capacity() == maxsize);
-    assert(tail->capacity() == maxsize);
+    assert(head->capacity() == nbytes);
+    assert(tail->capacity() == nbytes);
 
     // Check that the containers are empty
     assert(head->empty());
@@ -28,6 +48,14 @@ Buffer::Buffer(const size_t &n, const std::string &name) :
 
 }
 
+// Destructor
+Buffer::~Buffer() {
+
+    // Make sure the writer is done with the containers before they go
+    if (writer) writer->wait(*tail);
+
+}
+
 // Function to open the file
 void Buffer::open() {
 
@@ -37,57 +65,227 @@ void Buffer::open() {
     // Check that the file is open
     if (!file.is_open()) 
         throw std::runtime_error("Unable to open file " + filename);
+
+    // Remember it
+    opened = true;
     
 }
 
+// Function to append a value to the head with the width of a given type
+template <typename T>
+void Buffer::push(const double &x) {
+
+    // x: the value to append
+
+    // Check that integers are whole and within range
+    assert(std::is_floating_point_v<T> || (x >= 0.0 && x <= static_cast<double>(std::numeric_limits<T>::max()) && x == std::floor(x)));
+
+    // Convert
+    const T value = static_cast<T>(x);
+
+    // Append its bytes
+    const size_t n = head->size();
+    head->resize(n + sizeof(T));
+    std::memcpy(head->data() + n, &value, sizeof(T));
+
+}
+
 // Function to store a new value
 void Buffer::save(const double &x) {
 
     // x: the value to store
 
     // Check that we are below storage capacity
-    assert(head->size() < maxsize);
+    assert(count < maxsize);
 
     // Add the value to the active container
-    head->push_back(x);
+    switch (type) {
+
+        case prt::bit:
+
+            // Check
+            assert(x == 0.0 || x == 1.0);
+
+            // Start a new byte every eight values and set the bit
+            if (count % 8u == 0u) head->push_back(0u);
+            head->back() |= static_cast<uint8_t>(x != 0.0) << (count % 8u);
+            break;
+
+        case prt::u8: push<uint8_t>(x); break;
+        case prt::u16: push<uint16_t>(x); break;
+        case prt::u32: push<uint32_t>(x); break;
+        case prt::f32: push<float>(x); break;
+        case prt::f64: push<double>(x); break;
+
+    }
+
+    // One more value
+    ++count;
 
     // If the maximum allowed capacity is reached...
-    if (head->size() == maxsize) flush();
+    if (count == maxsize) flush();
+
+}
+
+// Function to return the last value stored
+double Buffer::last() const {
+
+    // Check
+    assert(count > 0u);
+
+    // Read the last bit...
+    if (type == prt::bit) return (head->back() >> ((count - 1u) % 8u)) & 1u;
+
+    // ... or the bytes of the last value
+    const uint8_t *p = head->data() + head->size() - prt::bits(type) / 8u;
 
+    // Convert them back
+    switch (type) {
+        case prt::u8: return *p;
+        case prt::u16: { uint16_t v; std::memcpy(&v, p, sizeof v); return v; }
+        case prt::u32: { uint32_t v; std::memcpy(&v, p, sizeof v); return v; }
+        case prt::f32: { float v; std::memcpy(&v, p, sizeof v); return v; }
+        default: { double v; std::memcpy(&v, p, sizeof v); return v; }
+    }
 }
 
 // Function to write all the content of the buffer to file
 void Buffer::flush() {
 
     // Make sure the file is open
-    assert(file.is_open());
+    assert(opened);
+
+    // Nothing to write (no empty chunks)
+    if (count == 0u) return;
+
+    // How to write the values
+    cdc::Frame frame;
+    frame.chunk = compress || bound > 0.0;
+    frame.compress = compress;
+    frame.count = count;
+    frame.width = prt::bits(type) / 8u;
+
+    // Quantize them if needed
+    if (bound > 0.0) quantize(frame);
+
+    // Wait until the tail has been written, if it is being written in the background
+    if (writer) writer->wait(*tail);
+
+    // Check
+    assert(tail->empty());
 
     // Swap the head and tail of the buffer
     std::swap(head, tail);
+    count = 0u;
 
-    // Write every stored value to file
-    file.write((char *) tail->data(), tail->size() * sizeof(double));
+    // Make sure the head is empty
+    assert(head->empty());
+
+    // Hand the tail over to be written in the background if possible...
+    if (writer) {
+        writer->write(file, *tail, frame);
+        return;
+    }
+
+    // ... or write every stored value to file (as a chunk if needed)
+    if (frame.chunk) {
+        std::vector<uint8_t> chunk;
+        cdc::encode(chunk, *tail, frame);
+        file.write((char *) chunk.data(), chunk.size());
+    }
+    else
+        file.write((char *) tail->data(), tail->size());
 
     // Empty the tail
     tail->clear();
 
     // Make sure the buffer is empty
-    assert(head->empty());
     assert(tail->empty());
 
 }
 
+// Function to replace the values in the head by quantized ones
+void Buffer::quantize(cdc::Frame &frame) {
+
+    // frame: how the values are written (updated if they are quantized)
+
+    // Check
+    assert(type == prt::f64);
+    assert(bound > 0.0);
+    assert(count > 0u);
+    assert(head->size() == count * sizeof(double));
+
+    // Function to read a value
+    auto value = [&](const size_t &i) {
+        double x;
+        std::memcpy(&x, head->data() + i * sizeof(double), sizeof(double));
+        return x;
+    };
+
+    // Range of the values (leaving them as they are if any is not finite)
+    double lo = value(0u), hi = lo;
+    for (size_t i = 0u; i < count; ++i) {
+        const double x = value(i);
+        if (!std::isfinite(x)) return;
+        lo = std::min(lo, x);
+        hi = std::max(hi, x);
+    }
+
+    // Distance between levels (so the nearest one is within the bound)
+    const double step = 2.0 * bound;
+
+    // Function to find the level of a value
+    auto level = [&](const double &x) { return std::floor((x - lo) / step + 0.5); };
+
+    // Number of the top level
+    const double top = level(hi);
+
+    // Width of the integers needed (leaving the values as they are if too many levels)
+    const size_t width = top <= std::numeric_limits<uint16_t>::max() ? 2u : top <= std::numeric_limits<uint32_t>::max() ? 4u : 0u;
+    if (!width) return;
+
+    // Check that every value will be read back within the bound
+    for (size_t i = 0u; i < count; ++i) {
+        const double x = value(i);
+        if (!(std::abs(lo + step * level(x) - x) <= bound)) return;
+    }
+
+    // Replace the values by their levels (narrower, so they can go in place from the front)
+    for (size_t i = 0u; i < count; ++i) {
+        const uint32_t q = static_cast<uint32_t>(level(value(i)));
+        if (width == 2u) {
+            const uint16_t v = static_cast<uint16_t>(q);
+            std::memcpy(head->data() + i * width, &v, width);
+        }
+        else
+            std::memcpy(head->data() + i * width, &q, width);
+    }
+
+    // Drop what is left
+    head->resize(count * width);
+
+    // Tell how to read them back
+    frame.width = width;
+    frame.offset = lo;
+    frame.scale = step;
+
+}
+
 // Function to close the output data file
 void Buffer::close() {
 
     // Check that the file is open
-    assert(file.is_open());
+    assert(opened);
 
     // Flush whatever is left
     flush();
 
-    // Close the file
+    // Wait until it has been written
+    if (writer) writer->wait(*tail);
+
+    // Close the file (nothing is being written to it anymore)
     file.close();
+    opened = false;
 
     // Check that the file is closed
     assert(!file.is_open());
@@ -7,7 +7,24 @@
 // head buffer, then its content is moved to the tail buffer by swapping the two containers,
 // and from there the content is flushed to file, and the tail buffer is cleared. In the
 // meantime, the previous tail buffer has already been emptied and is now the new head buffer,
-// ready to take in new values. This approach is to avoid too much waiting for I/O operations.  
+// ready to take in new values. This approach is to avoid too much waiting for I/O operations.
+// When given a Writer, the tail buffer is written to file by its background thread while
+// values keep going into the head buffer, and saving only has to wait if the head buffer
+// fills up before the tail buffer has been written. Otherwise, the tail buffer is written
+// right away. Either way, closing the buffer returns once everything is in the file.
+// Values are written with the width of the type of the buffer (see prt::Type), e.g.
+// counts as 32-bit unsigned integers and flags as single bits packed eight to a byte
+// (first value in the lowest bit, the last byte padded with zeros), in the byte order
+// of the machine. Buffers can also be told to compress what they write, in which case
+// each flush makes a chunk of the file (see cdc). Buffers of doubles can be given an
+// error bound, in which case each flush quantizes its values, i.e. rounds them to the
+// nearest of evenly spaced levels (twice the bound apart, starting from the smallest
+// value) and writes the number of the level as a 16- or 32-bit unsigned integer, in a
+// chunk that gives the offset and scale needed to read the values back. Values that
+// cannot be quantized within the bound with 32 bits (or that are not finite) stay
+// doubles in their chunk.
+
+#include "writer.hpp"
 
 #include <vector>
 #include <fstream>
@@ -15,48 +32,109 @@
 #include <string>
 #include <cassert>
 #include <algorithm>
+#include <cstring>
+#include <cstdint>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
+namespace prt {
+
+    // Types values can be written as
+    enum Type {
+        bit, // flags (zero or one)
+        u8,  // unsigned integers below 2^8
+        u16, // unsigned integers below 2^16
+        u32, // unsigned integers below 2^32
+        f32, // single precision floating point numbers
+        f64  // double precision floating point numbers
+    };
+
+    // Function to tell the number of bits a value of a given type takes
+    inline size_t bits(const Type &type) {
+
+        // type: the type
+
+        switch (type) {
+            case bit: return 1u;
+            case u8: return 8u;
+            case u16: return 16u;
+            case u32: return 32u;
+            case f32: return 32u;
+            default: return 64u;
+        }
+    }
+}
 
 class Buffer {
 
 public:
 
     // Constructor
-    Buffer(const size_t&, const std::string&);
+    Buffer(const size_t&, const std::string&, const prt::Type& = prt::f64, Writer* = nullptr, const bool& = false, const double& = 0.0);
+
+    // Destructor
+    ~Buffer();
+
+    // No copies (the writer may hold on to the containers)
+    Buffer(const Buffer&) = delete;
+    Buffer& operator=(const Buffer&) = delete;
 
     // Setters
     void open();
     void save(const double&);
     void close();
 
-    // Function to return the last value stored
-    double last() const { return head->back(); };
+    // Getters
+    double last() const;
 
-    // Function to return buffer capacity
-    size_t capacity() const { return head->capacity(); };
+    // Function to return buffer capacity (in number of values)
+    size_t capacity() const { return maxsize; };
 
     // Function to return the number of values stored 
-    size_t size() const { return head->size(); };
+    size_t size() const { return count; };
 
-    // Function to tell if the file is open
-    bool isopen() const { return file.is_open(); };
+    // Function to tell if the file is open (without touching the stream, which
+    // the background writer may be using)
+    bool isopen() const { return opened; };
 
 private:
 
     // Name of the file
     std::string filename;
 
-    // Maximum possible size of the buffer
+    // Maximum possible size of the buffer (in number of values)
     size_t maxsize;
 
-    // Smart pointers to data containers
-    std::unique_ptr<std::vector<double> > head;
-    std::unique_ptr<std::vector<double> > tail;
+    // Type values are written as
+    prt::Type type;
+
+    // Smart pointers to data containers (of encoded values)
+    std::unique_ptr<std::vector<uint8_t> > head;
+    std::unique_ptr<std::vector<uint8_t> > tail;
+
+    // Number of values in the head
+    size_t count;
 
     // Smart pointer to an output file stream
     std::ofstream file;
 
+    // Whether the file is open
+    bool opened;
+
+    // Background writer (if any)
+    Writer *writer;
+
+    // Whether to compress
+    bool compress;
+
+    // Error bound of quantized values (zero to keep them exact)
+    double bound;
+
     // Internal setters
     void flush();
+    void quantize(cdc::Frame&);
+    template <typename T> void push(const double&);
 
 };
 
@@ -0,0 +1,244 @@
+// This script contains functions of the cdc namespace.
+
+#include "codec.hpp"
+
+// Function to compress a container of values into a chunk
+void cdc::encode(std::vector<uint8_t> &chunk, const std::vector<uint8_t> &data, const Frame &frame) {
+
+    // chunk: where to put the chunk (emptied first)
+    // data: bytes of the values
+    // frame: how to write them (number and width of the values, etc.)
+
+    // Number and width of the values
+    const size_t count = frame.count;
+    const size_t width = frame.width;
+
+    // Check
+    assert(width <= 8u);
+    assert(data.size() == (width ? count * width : (count + 7u) / 8u));
+    assert(frame.scale == 0.0 || width == 2u || width == 4u);
+
+    // Width of the values to take differences between (bits go by the byte)
+    const size_t w = width ? width : 1u;
+
+    // Number of such values
+    size_t n = data.size() / w;
+
+    // Start the chunk (header filled in at the end)
+    chunk.clear();
+    chunk.reserve(header + data.size() + (n + 1u) / 2u);
+    chunk.resize(header);
+
+    // Skip the differences if not compressing
+    if (!frame.compress) n = 0u;
+
+    // Zero before the first value
+    const uint8_t zero[8u] = {0u};
+    const uint8_t *prev = zero;
+
+    // Position of the current code byte
+    size_t code = header;
+
+    // For each value...
+    for (size_t i = 0u; i < n; ++i) {
+
+        // Pointer to the value
+        const uint8_t *cur = data.data() + i * w;
+
+        // Difference with the previous one
+        uint8_t diff[8u];
+        size_t keep = 0u;
+        for (size_t k = 0u; k < w; ++k) {
+            diff[k] = cur[k] ^ prev[k];
+            if (diff[k]) keep = k + 1u;
+        }
+
+        // Start a new code byte every two values
+        if (i % 2u == 0u) {
+            code = chunk.size();
+            chunk.push_back(0u);
+        }
+
+        // Add the number of bytes kept to it
+        chunk[code] |= static_cast<uint8_t>(keep << (4u * (i % 2u)));
+
+        // Add the bytes kept
+        chunk.insert(chunk.end(), diff, diff + keep);
+
+        // Move on
+        prev = cur;
+
+    }
+
+    // Method to say we used
+    Method method = delta;
+
+    // Store the values as they are if that is not smaller (or if not compressing)
+    if (!frame.compress || chunk.size() >= header + data.size()) {
+        chunk.resize(header);
+        chunk.insert(chunk.end(), data.begin(), data.end());
+        method = raw;
+    }
+
+    // Fill in the header
+    const uint64_t nvalues = count;
+    const uint64_t nbytes = chunk.size() - header;
+    const uint8_t nwidth = static_cast<uint8_t>(width);
+    chunk[0u] = version;
+    std::memcpy(chunk.data() + 1u, &nvalues, 8u);
+    std::memcpy(chunk.data() + 9u, &nbytes, 8u);
+    chunk[17u] = nwidth;
+    chunk[18u] = method;
+    std::memcpy(chunk.data() + 19u, &frame.offset, 8u);
+    std::memcpy(chunk.data() + 27u, &frame.scale, 8u);
+
+}
+
+// Function to read back the values of a sequence of chunks
+std::vector<uint8_t> cdc::decode(const std::vector<uint8_t> &stream) {
+
+    // stream: the chunks (e.g. the content of a compressed file)
+
+    // Note: this returns the bytes the values would have been written as
+    // without compression (quantized values being turned back into doubles).
+
+    // Prepare storage
+    std::vector<uint8_t> data;
+
+    // Position in the stream
+    size_t pos = 0u;
+
+    // For each chunk...
+    while (pos < stream.size()) {
+
+        // Check that there is a header
+        if (stream.size() - pos < header)
+            throw std::runtime_error("Truncated chunk header");
+
+        // Check that we know how to read it
+        if (stream[pos] != version)
+            throw std::runtime_error("Unsupported chunk version");
+
+        // Read it
+        uint64_t count, nbytes;
+        double offset, scale;
+        std::memcpy(&count, stream.data() + pos + 1u, 8u);
+        std::memcpy(&nbytes, stream.data() + pos + 9u, 8u);
+        const size_t width = stream[pos + 17u];
+        const uint8_t method = stream[pos + 18u];
+        std::memcpy(&offset, stream.data() + pos + 19u, 8u);
+        std::memcpy(&scale, stream.data() + pos + 27u, 8u);
+        pos += header;
+
+        // Check that there is a payload
+        if (stream.size() - pos < nbytes)
+            throw std::runtime_error("Truncated chunk");
+
+        // Check the width (quantized values are 16- or 32-bit integers)
+        if (width > 8u || (scale != 0.0 && width != 2u && width != 4u))
+            throw std::runtime_error("Invalid value width in chunk");
+
+        // Number of bytes once decoded
+        const size_t size = width ? count * width : (count + 7u) / 8u;
+
+        // Where the chunk starts in the data
+        const size_t start = data.size();
+
+        // Values stored as they are...
+        if (method == raw) {
+
+            // Check
+            if (nbytes != size)
+                throw std::runtime_error("Invalid chunk size");
+
+            // Copy them
+            data.insert(data.end(), stream.begin() + pos, stream.begin() + pos + nbytes);
+            pos += nbytes;
+
+        }
+
+        // ... or as differences
+        else if (method == delta) {
+
+            // Width of the values differences were taken between
+            const size_t w = width ? width : 1u;
+
+            // End of the payload
+            const size_t end = pos + nbytes;
+
+            // Position of the current code byte
+            size_t code = pos;
+
+            // For each value...
+            for (size_t i = 0u; i < size / w; ++i) {
+
+                // Move to a new code byte every two values
+                if (i % 2u == 0u) {
+                    if (pos >= end)
+                        throw std::runtime_error("Invalid chunk size");
+                    code = pos++;
+                }
+
+                // Number of bytes kept
+                const size_t keep = (stream[code] >> (4u * (i % 2u))) & 15u;
+
+                // Check
+                if (keep > w || end - pos < keep)
+                    throw std::runtime_error("Invalid chunk size");
+
+                // Previous value (zero for the first one)
+                const size_t j = data.size();
+                for (size_t k = 0u; k < w; ++k)
+                    data.push_back(j > start ? data[j - w + k] : 0u);
+
+                // Undo the difference
+                for (size_t k = 0u; k < keep; ++k) data[j + k] ^= stream[pos + k];
+
+                // Move on
+                pos += keep;
+
+            }
+
+            // Check that the whole payload was used
+            if (pos != end)
+                throw std::runtime_error("Invalid chunk size");
+
+        }
+        else
+            throw std::runtime_error("Invalid compression method in chunk");
+
+        // Turn quantized values back into doubles if needed
+        if (scale != 0.0) {
+
+            // Prepare storage
+            std::vector<uint8_t> values(count * sizeof(double));
+
+            // For each value...
+            for (size_t i = 0u; i < count; ++i) {
+
+                // Read the integer
+                uint32_t q = 0u;
+                if (width == 2u) {
+                    uint16_t v;
+                    std::memcpy(&v, data.data() + start + i * width, width);
+                    q = v;
+                }
+                else
+                    std::memcpy(&q, data.data() + start + i * width, width);
+
+                // Scale it back
+                const double x = offset + scale * q;
+                std::memcpy(values.data() + i * sizeof(double), &x, sizeof(double));
+
+            }
+
+            // Replace the integers
+            data.resize(start);
+            data.insert(data.end(), values.begin(), values.end());
+
+        }
+    }
+
+    return data;
+
+}
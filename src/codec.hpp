@@ -0,0 +1,67 @@
+#ifndef RESCHOICE_CODEC_HPP
+#define RESCHOICE_CODEC_HPP
+
+// This header is for the cdc (codec) namespace, which contains functions to
+// compress containers of values before they are written to file, and to read
+// them back. A compressed file is a sequence of chunks, one per flushed buffer,
+// each made of a header and a payload, so files can be read one chunk at a time
+// and a chunk can be read without the ones before it. The header holds, in this
+// order, the version of the format (1 byte, so the header can change without
+// making older files unreadable), the number of values (8 bytes), the size of
+// the payload (8 bytes, in bytes), the width of a value (1 byte, in bytes, or
+// zero for single bits), the method used (1 byte), and an offset and a scale
+// (8-byte doubles). A non-zero scale means that the values are quantized, i.e.
+// stored as unsigned integers to be multiplied by the scale and added to the
+// offset (see Buffer), and zero that they are stored as they are. With the raw
+// method the payload is the values as they would have been written
+// uncompressed. With the delta method, each value is XORed with the one before
+// it in the chunk (the first one with zero), so values close to each other
+// leave zero bytes at their most significant end. Only the bytes of the
+// difference up to its last non-zero one (in memory order, which puts the most
+// significant bytes last on little-endian machines) are kept, their number
+// being given by a four-bit code, two codes to a byte, the first in the lowest
+// four bits. Each code byte is followed by the kept bytes of its two values
+// (the last code byte of a chunk with an odd number of values has a single
+// code). Bits are treated as values of one byte. The raw method is used
+// whenever the delta method would not make the chunk smaller.
+
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <stdexcept>
+#include <cassert>
+
+namespace cdc {
+
+    // Compression methods
+    enum Method : uint8_t {
+        raw,  // values as they are
+        delta // XOR with the previous value, leading zero bytes dropped
+    };
+
+    // Version of the format written
+    const uint8_t version = 1u;
+
+    // Size of the header of a chunk (in bytes)
+    const size_t header = 35u;
+
+    // How to write a container of values
+    struct Frame {
+
+        bool chunk = false;     // whether to write it as a chunk
+        bool compress = false;  // whether to compress it (or only frame it)
+        size_t count = 0u;      // number of values
+        size_t width = 0u;      // width of a value (in bytes, zero for single bits)
+        double offset = 0.0;    // offset of quantized values
+        double scale = 0.0;     // scale of quantized values (zero if not quantized)
+
+    };
+
+    // Functions
+    void encode(std::vector<uint8_t>&, const std::vector<uint8_t>&, const Frame&);
+    std::vector<uint8_t> decode(const std::vector<uint8_t>&);
+
+}
+
+#endif
@@ -0,0 +1,158 @@
+// This script contains member functions of the Cohorts class.
+
+#include "cohorts.hpp"
+
+// Constructor
+Cohorts::Cohorts(const double &rate) :
+    delta(rate),
+    cohorts(std::vector<Cohort>())
+{
+
+    // rate: resource discovery rate
+
+    // Check
+    assert(delta >= 0.0);
+
+}
+
+// Function to reserve space for a number of classes
+void Cohorts::reserve(const size_t &n) {
+
+    // n: number of classes to make room for
+
+    cohorts.reserve(n);
+
+}
+
+// Function to remove all the classes (capacity is kept)
+void Cohorts::clear() {
+
+    cohorts.clear();
+
+}
+
+// Function to add a class of newly developed individuals
+void Cohorts::add(const double &x, const bool &habitat, const size_t &count, const double &tradeoff) {
+
+    // x: trait value
+    // habitat: habitat of the members
+    // count: number of members
+    // tradeoff: resource utilization tradeoff
+
+    // Set up the class
+    Cohort cohort;
+    cohort.x = x;
+    cohort.eff1 = ind::efficiency(x + 1.0, tradeoff);
+    cohort.eff2 = ind::efficiency(x - 1.0, tradeoff);
+    cohort.miss1 = exp(-delta * cohort.eff1);
+    cohort.miss2 = exp(-delta * cohort.eff2);
+    cohort.fitness = 0.0;
+    cohort.count = count;
+    cohort.chosen = {0u, 0u};
+    cohort.habitat = habitat;
+
+    // Check that feeding efficiencies are above zero
+    assert(cohort.eff1 >= 0.0);
+    assert(cohort.eff2 >= 0.0);
+
+    // Add it
+    cohorts.push_back(cohort);
+
+}
+
+// Function to add a class with the same trait value as another one
+void Cohorts::clone(const Cohort &other, const bool &habitat, const size_t &count) {
+
+    // other: class to copy the trait value (and what follows from it) from
+    // habitat: habitat of the members
+    // count: number of members
+
+    // Copy the class
+    Cohort cohort = other;
+
+    // Reset what is specific to the members
+    cohort.fitness = 0.0;
+    cohort.count = count;
+    cohort.chosen = {0u, 0u};
+    cohort.habitat = habitat;
+
+    // Add it
+    cohorts.push_back(cohort);
+
+}
+
+// Function to sort the classes and pool identical ones
+void Cohorts::merge() {
+
+    // Sort by habitat and then by trait value
+    std::sort(cohorts.begin(), cohorts.end(), [](const Cohort &a, const Cohort &b) {
+        return a.habitat != b.habitat ? a.habitat < b.habitat : a.x < b.x;
+    });
+
+    // Number of classes kept so far
+    size_t n = 0u;
+
+    // For each class...
+    for (size_t i = 0u; i < cohorts.size(); ++i) {
+
+        // Drop it if empty
+        if (!cohorts[i].count) continue;
+
+        // Pool it with the previous one if they are identical
+        if (n && cohorts[n - 1u].habitat == cohorts[i].habitat && cohorts[n - 1u].x == cohorts[i].x) {
+            cohorts[n - 1u].count += cohorts[i].count;
+            cohorts[n - 1u].fitness += cohorts[i].fitness;
+            continue;
+        }
+
+        // Otherwise keep it
+        cohorts[n++] = cohorts[i];
+
+    }
+
+    // Remove what is left over
+    cohorts.resize(n);
+
+}
+
+// Function to count the individuals
+size_t Cohorts::total() const {
+
+    // Add up the class sizes
+    size_t n = 0u;
+    for (const Cohort &cohort : cohorts) n += cohort.count;
+
+    return n;
+
+}
+
+// Function to find the first class in the second habitat
+size_t Cohorts::split() const {
+
+    // Note: this assumes that the classes are sorted (see merge).
+
+    // Find the first class that is not in the first habitat
+    size_t i = 0u;
+    while (i < size() && !cohorts[i].habitat) ++i;
+
+    return i;
+
+}
+
+// Function to find the class of an individual
+size_t Cohorts::find(const size_t &i) const {
+
+    // i: index of the individual (counting through the classes in order)
+
+    // Skip whole classes until the individual is reached
+    size_t n = 0u;
+    for (size_t j = 0u; j < size(); ++j) {
+        n += cohorts[j].count;
+        if (i < n) return j;
+    }
+
+    // Should not get here
+    assert(false);
+    return size();
+
+}
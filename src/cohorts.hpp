@@ -0,0 +1,71 @@
+#ifndef RESCHOICE_COHORTS_HPP
+#define RESCHOICE_COHORTS_HPP
+
+// This is the header for the Cohorts class, which holds a population as classes
+// of identical individuals (same trait value and habitat) along with their numbers.
+// When mutations are rare, most individuals share their trait value with many
+// others, so this takes memory in proportion to the number of distinct genotypes
+// rather than to the number of individuals. Unlike in Storage, each class is kept
+// as a whole record, because all of its attributes are needed whenever it is visited.
+// After a call to merge(), classes are sorted by habitat and then by trait value,
+// identical classes are pooled together and empty ones are dropped.
+
+#include "individual.hpp"
+
+#include <vector>
+#include <array>
+#include <algorithm>
+#include <cassert>
+
+// A class of identical individuals
+struct Cohort {
+
+    double x;                        // trait value
+    double eff1;                     // feeding efficiency on resource 1
+    double eff2;                     // feeding efficiency on resource 2
+    double miss1;                    // fraction of resource 1 left undiscovered by one member (see Storage)
+    double miss2;                    // fraction of resource 2 left undiscovered by one member
+    double fitness;                  // total fitness of all the members
+    size_t count;                    // number of members
+    std::array<size_t, 2u> chosen;   // number of members feeding on each resource in the current round
+    bool habitat;                    // habitat where the members live
+
+};
+
+class Cohorts {
+
+public:
+
+    // Constructor
+    Cohorts(const double& = 0.0);
+
+    // Setters
+    void reserve(const size_t&);
+    void clear();
+    void add(const double&, const bool&, const size_t&, const double&);
+    void clone(const Cohort&, const bool&, const size_t&);
+    void merge();
+
+    // Size getters
+    size_t size() const { return cohorts.size(); };
+    size_t total() const;
+    size_t split() const;
+
+    // Function to find the class of an individual
+    size_t find(const size_t&) const;
+
+    // Access to the classes
+    Cohort& operator[](const size_t &i) { assert(i < size()); return cohorts[i]; };
+    const Cohort& operator[](const size_t &i) const { assert(i < size()); return cohorts[i]; };
+
+private:
+
+    // Resource discovery rate
+    double delta;
+
+    // The classes
+    std::vector<Cohort> cohorts;
+
+};
+
+#endif
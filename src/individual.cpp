@@ -8,10 +8,10 @@ Individual::Individual(const double &xval, const double &tradeoff) :
     eff1(0.0),
     eff2(0.0),
     diff(0.0),
+    rank(0u),
     habitat(false),
     ecotype(false),
-    choice(false),
-    rank(0u)
+    choice(false)
 {
 
     // Update feeding efficiencies
@@ -55,39 +55,41 @@ double ind::probbest(const double &pbase, const double &beta) {
 
 }
 
-// Function to set the resource choice
-void Individual::makeChoice(const double &fit1, const double &fit2, const double &alpha, const double &beta, const double &res1, const double &res2) { 
+// Function to compute the probabilities of choosing resource 2
+ind::Thresholds ind::thresholds(const double &alpha, const double &beta, const double &res1, const double &res2) {
 
-    // fit1, fit2: expected payoff for each resource
     // alpha: weight of resource abundance when choice is random
     // beta: optimal choice parameter
     // res1, res2: total contrentrations of both resources
 
-    // Which resource is better? (pick at random if they are equal)
-    const bool best = fit1 == fit2 ? rnd::bernoulli(0.5)(rnd::rng) : fit2 > fit1;
+    // Note: these only depend on the habitat and on which resource is best,
+    // so they can be computed once and reused for every choice in a habitat.
 
-    // Concentration of the best resource
-    const double rbest = best ? res2 : res1;
+    // Probability of choosing the best resource when it is resource 1...
+    const double prob1 = ind::probbest(ind::probbase(res1, res1 + res2, alpha), beta);
 
-    // Baseline probability of choosing the best resource without choice
-    const double pbase = ind::probbase(rbest, res1 + res2, alpha);
+    // ... or resource 2
+    const double prob2 = ind::probbest(ind::probbase(res2, res1 + res2, alpha), beta);
 
     // Check
-    assert(pbase >= 0.0);
-    assert(pbase <= 1.0);
+    assert(prob1 >= 0.0 && prob1 <= 1.0);
+    assert(prob2 >= 0.0 && prob2 <= 1.0);
 
-    // Probability of choosing the best resource
-    const double prob = ind::probbest(pbase, beta);
+    // Probabilities of choosing resource 2 (ties are broken at random first)
+    return { 1.0 - prob1, prob2, 0.5 * (1.0 - prob1) + 0.5 * prob2 };
 
-    // Check
-    assert(prob >= 0.0);
-    assert(prob <= 1.0);
+}
+
+// Function to set the resource choice
+void Individual::makeChoice(const double &fit1, const double &fit2, const double &alpha, const double &beta, const double &res1, const double &res2) { 
 
-    // Is the best resource chosen?
-    const bool isAccurate = rnd::bernoulli(prob)(rnd::rng);
+    // fit1, fit2: expected payoff for each resource
+    // alpha: weight of resource abundance when choice is random
+    // beta: optimal choice parameter
+    // res1, res2: total contrentrations of both resources
 
-    // Make the choice
-    choice = best == isAccurate;
+    // Make the choice with a single draw
+    choice = ind::choose(fit1, fit2, ind::thresholds(alpha, beta, res1, res2), rnd::uniform(0.0, 1.0)(rnd::rng));
     
 }
 
@@ -121,8 +123,8 @@ void Individual::setEcotype(const double &meanx) {
 void Individual::develop(const double &tradeoff) {
 
     // Update feeding efficiencies
-    eff1 = exp(-tradeoff * utl::sqr(x + 1.0));
-    eff2 = exp(-tradeoff * utl::sqr(x - 1.0));
+    eff1 = ind::efficiency(x + 1.0, tradeoff);
+    eff2 = ind::efficiency(x - 1.0, tradeoff);
 
     // Check that feeding efficiencies are still above zero
     assert(eff1 >= 0.0);
@@ -140,16 +142,9 @@ void Individual::disperse() {
 // Function to assign a rank in the queue to an individual during a feeding round
 void Individual::setRank(const size_t &i) {
 
-    rank = i;
+    // Check that the rank fits in its narrow storage
+    assert(i <= UINT32_MAX);
 
-}
+    rank = static_cast<uint32_t>(i);
 
-// Getters
-double Individual::getX() const { return x; }
-double Individual::getEff1() const { return eff1; }
-double Individual::getEff2() const { return eff2; }
-double Individual::getDiff() const { return diff; }
-bool Individual::getHabitat() const { return habitat; }
-bool Individual::getEcotype() const { return ecotype; }
-bool Individual::getChoice() const { return choice; }
-size_t Individual::getRank() const { return rank; }
\ No newline at end of file
+}
@@ -8,13 +8,37 @@
 
 #include <cmath>
 #include <cassert>
+#include <cstdint>
+#include <array>
 
 namespace ind {
 
+    // Probabilities of choosing resource 2 when resource 1 is better, when
+    // resource 2 is better and when both are equally good, respectively
+    typedef std::array<double, 3u> Thresholds;
+
     // Accessory functions
     double probbase(const double&, const double&, const double&);
     double probbest(const double&, const double&);
+    Thresholds thresholds(const double&, const double&, const double&, const double&);
+
+    // Feeding efficiency given the distance to a resource optimum
+    inline double efficiency(const double &dx, const double &tradeoff) { return exp(-tradeoff * utl::sqr(dx)); }
+
+    // Function to choose a resource (true for resource 2) from a single uniform draw
+    inline bool choose(const double &fit1, const double &fit2, const Thresholds &probs, const double &u) {
+
+        // fit1, fit2: expected payoff for each resource
+        // probs: probabilities of choosing resource 2 in each case
+        // u: uniform deviate between zero and one
 
+        // Which case are we in? (see Thresholds)
+        const size_t k = (fit2 > fit1) + 2u * (fit1 == fit2);
+
+        // Compare the draw to the threshold
+        return u < probs[k];
+
+    }
 }
 
 class Individual {
@@ -34,25 +58,28 @@ public:
     void setRank(const size_t&); 
 
     // Getters
-    double getX() const;
-    double getEff1() const;
-    double getEff2() const;
-    double getDiff() const;
-    bool getHabitat() const;
-    bool getEcotype() const;
-    bool getChoice() const;
-    size_t getRank() const;
+    utl::Real getX() const { return x; }
+    utl::Real getEff1() const { return eff1; }
+    utl::Real getEff2() const { return eff2; }
+    utl::Real getDiff() const { return diff; }
+    bool getHabitat() const { return habitat; }
+    bool getEcotype() const { return ecotype; }
+    bool getChoice() const { return choice; }
+    size_t getRank() const { return rank; }
 
 private:
 
-    double x;       // trait value
-    double eff1;    // feeding efficiency on resource 1
-    double eff2;    // feeding efficiency on resource 2
-    double diff;    // expected fitness difference
-    bool habitat;   // habitat where the individual lives
-    bool ecotype;   // what resource is the individual more adapted to relative to the pop average
-    bool choice;    // which resource is chosen?
-    size_t rank;    // individual position in a queue during a feeding round
+    // Storage reads individuals back from its columns
+    friend class Storage;
+
+    utl::Real x;     // trait value
+    utl::Real eff1;  // feeding efficiency on resource 1
+    utl::Real eff2;  // feeding efficiency on resource 2
+    utl::Real diff;  // expected fitness difference
+    uint32_t rank;   // individual position in a queue during a feeding round
+    bool habitat;    // habitat where the individual lives
+    bool ecotype;    // what resource is the individual more adapted to relative to the pop average
+    bool choice;     // which resource is chosen?
 
 };
 
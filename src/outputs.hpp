@@ -0,0 +1,62 @@
+#ifndef RESCHOICE_OUTPUTS_HPP
+#define RESCHOICE_OUTPUTS_HPP
+
+// This header is for the out (outputs) namespace, which lists the outputs the
+// simulation can save, with the type each is written as (see Buffer). The list
+// is written once, below, and expanded into an enumeration (to refer to an
+// output in the code, see Printer::channel), the list of names (to request it in
+// whattosave.txt) and the list of types, so these cannot differ. To add an
+// output, add a line to the list.
+
+#include "buffer.hpp"
+
+#include <vector>
+#include <string>
+
+// List of outputs
+#define RESCHOICE_OUTPUTS(X) \
+    X(time, prt::u32)                                   /* time steps */ \
+    X(resourceCensus, prt::u32)                         /* number of individuals feeding on each resource at each feeding round in each habitat */ \
+    X(resourceMeanTraitValue, prt::f64)                 /* mean trait value of individuals feeding on each resource at each feeding round in each habitat */ \
+    X(individualExpectedFitnessDifference, prt::f64)    /* expected fitness difference between the resources for each individual at each feeding round */ \
+    X(individualChoice, prt::bit)                       /* resource choice made by each individual at each feeding round */ \
+    X(individualRealizedFitness, prt::f64)              /* realized fitness gain of each individual after each feeding round */ \
+    X(individualRank, prt::u32)                         /* position of each individual in the feeding queue at each feeding round */ \
+    X(individualHabitat, prt::bit)                      /* habitat of each individual */ \
+    X(individualTraitValue, prt::f64)                   /* trait value of each individual */ \
+    X(individualTotalFitness, prt::f64)                 /* total fitness of each individual after all feeding rounds */ \
+    X(individualEcotype, prt::bit)                      /* ecotype of each individual (relative to population average) */ \
+    X(habitatCensus, prt::u32)                          /* number of individuals in each habitat */ \
+    X(habitatMeanTraitValue, prt::f64)                  /* mean trait value in each habitat */ \
+    X(ecologicalIsolation, prt::f64)                    /* ecological isolation statistic */ \
+    X(spatialIsolation, prt::f64)                       /* spatial isolation statistic */ \
+    X(traitMean, prt::f64)                              /* trait mean in the population */ \
+    X(traitStandardDeviation, prt::f64)                 /* trait standard deviation in the population */
+
+namespace out {
+
+    // Outputs, in the order of the list
+    #define RESCHOICE_OUTPUT_ENUM(name, type) name,
+    enum Output : size_t { RESCHOICE_OUTPUTS(RESCHOICE_OUTPUT_ENUM) noutputs };
+    #undef RESCHOICE_OUTPUT_ENUM
+
+    // Function to return the names of the outputs, in the same order
+    inline std::vector<std::string> names() {
+
+        #define RESCHOICE_OUTPUT_NAME(name, type) #name,
+        return { RESCHOICE_OUTPUTS(RESCHOICE_OUTPUT_NAME) };
+        #undef RESCHOICE_OUTPUT_NAME
+
+    }
+
+    // Function to return the types the outputs are written as, in the same order
+    inline std::vector<prt::Type> types() {
+
+        #define RESCHOICE_OUTPUT_TYPE(name, type) type,
+        return { RESCHOICE_OUTPUTS(RESCHOICE_OUTPUT_TYPE) };
+        #undef RESCHOICE_OUTPUT_TYPE
+
+    }
+}
+
+#endif
@@ -31,7 +31,15 @@ Parameters::Parameters(const std::string &filename) :
     savedat(false),
     verbose(false),
     choose(false),
-    memsave(1.0)
+    memsave(1.0),
+    multinomial(false),
+    nthreads(1u),
+    renormalize(0u),
+    cohorts(false),
+    prefetch(0u),
+    blocksize(1u),
+    speculate(false),
+    compress(false)
 {
     
     // filename: optional parameter input file
@@ -60,6 +68,8 @@ void Parameters::check() const
     assert(tend > 0u);
     assert(tsave > 0u);
     assert(memsave >= 0.0);
+    assert(nthreads > 0u);
+    assert(blocksize > 0u);
     
 }
 
@@ -114,6 +124,14 @@ void Parameters::read(const std::string &filename)
         else if (name == "verbose") reader.readvalue<bool>(verbose);
         else if (name == "choose") reader.readvalue<bool>(choose);
         else if (name == "memsave") reader.readvalue<double>(memsave, chk::enoughmb<double>);
+        else if (name == "multinomial") reader.readvalue<bool>(multinomial);
+        else if (name == "nthreads") reader.readvalue<size_t>(nthreads, chk::strictpos<size_t>);
+        else if (name == "renormalize") reader.readvalue<size_t>(renormalize);
+        else if (name == "cohorts") reader.readvalue<bool>(cohorts);
+        else if (name == "prefetch") reader.readvalue<size_t>(prefetch);
+        else if (name == "blocksize") reader.readvalue<size_t>(blocksize, chk::strictpos<size_t>);
+        else if (name == "speculate") reader.readvalue<bool>(speculate);
+        else if (name == "compress") reader.readvalue<bool>(compress);
         else
             reader.readerror();
 
@@ -160,6 +178,14 @@ void Parameters::save(const std::string &filename) const
     file << "verbose " << verbose << '\n';
     file << "choose " << choose << '\n';
     file << "memsave " << memsave << '\n';
+    file << "multinomial " << multinomial << '\n';
+    file << "nthreads " << nthreads << '\n';
+    file << "renormalize " << renormalize << '\n';
+    file << "cohorts " << cohorts << '\n';
+    file << "prefetch " << prefetch << '\n';
+    file << "blocksize " << blocksize << '\n';
+    file << "speculate " << speculate << '\n';
+    file << "compress " << compress << '\n';
 
     // Close the file
     file.close();
@@ -42,6 +42,14 @@ struct Parameters {
     bool verbose;        // whether to output to screen
     bool choose;         // whether to choose the variables to save
     double memsave;      // memory used for data storage (in MB)
+    bool multinomial;    // whether to sample offspring numbers per parent
+    size_t nthreads;     // number of threads
+    size_t renormalize;  // number of feeders between exact updates of resource discovery
+    bool cohorts;        // whether to store classes of identical individuals
+    size_t prefetch;     // how far ahead in the feeding queue to prefetch individuals
+    size_t blocksize;    // number of feeders choosing at the same time (one for the exact model)
+    bool speculate;      // whether to feed across threads by guessing ahead
+    bool compress;       // whether to compress output data
 
 };
 
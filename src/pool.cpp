@@ -0,0 +1,117 @@
+// This script contains member functions of the Pool class.
+
+#include "pool.hpp"
+
+// Constructor
+Pool::Pool(const size_t &nthreads) :
+    workers(std::vector<std::thread>()),
+    task(nullptr),
+    call(nullptr),
+    ntasks(0u),
+    next(0u),
+    batch(0u),
+    busy(0u),
+    stop(false)
+{
+
+    // nthreads: total number of threads (including the calling one)
+
+    // Check
+    assert(nthreads > 0u);
+
+    // Start the workers
+    workers.reserve(nthreads - 1u);
+    for (size_t i = 1u; i < nthreads; ++i)
+        workers.emplace_back(&Pool::work, this);
+
+}
+
+// Destructor
+Pool::~Pool() {
+
+    // Tell the workers to stop
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stop = true;
+    }
+
+    // Wake them up
+    wake.notify_all();
+
+    // Wait for them to finish
+    for (auto &worker : workers) worker.join();
+
+}
+
+// Function to share a batch of tasks with the workers
+void Pool::dispatch(const size_t &n, const void *f, void (*c)(const void*, const size_t&)) {
+
+    // n: number of tasks
+    // f: function to run
+    // c: how to call it
+
+    // Set up the batch
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        task = f;
+        call = c;
+        ntasks = n;
+        next = 0u;
+        busy = workers.size();
+        ++batch;
+    }
+
+    // Wake the workers up
+    wake.notify_all();
+
+    // Take part in the work
+    pick();
+
+    // Wait for the workers to be done
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [this] { return busy == 0u; });
+
+    // Check
+    assert(next >= ntasks);
+
+}
+
+// Function to pick tasks until there are none left
+void Pool::pick() {
+
+    // Claim tasks one at a time
+    for (size_t i = next++; i < ntasks; i = next++) call(task, i);
+
+}
+
+// Function run by each worker
+void Pool::work() {
+
+    // Last batch seen
+    size_t seen = 0u;
+
+    // Until told to stop...
+    while (true) {
+
+        // Wait for a new batch
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [&] { return stop || batch != seen; });
+            if (stop) return;
+            seen = batch;
+        }
+
+        // Do some of the work
+        pick();
+
+        // Report when done
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            --busy;
+        }
+
+        // Let the calling thread know
+        done.notify_one();
+
+    }
+}
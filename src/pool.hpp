@@ -0,0 +1,82 @@
+#ifndef RESCHOICE_POOL_HPP
+#define RESCHOICE_POOL_HPP
+
+// This is the header for the Pool class, a fixed set of worker threads that
+// can be handed a number of independent tasks (e.g. chunks of individuals) to
+// run in parallel. The calling thread takes part in the work and only returns
+// once all the tasks are done. Tasks are picked up in no particular order, so
+// anything that must be reproducible should only depend on the task index
+// (e.g. random numbers drawn from a stream keyed by that index, see rnd::Philox).
+// With a single thread, tasks are simply run in order on the calling thread.
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <cassert>
+
+class Pool {
+
+public:
+
+    // Constructor
+    Pool(const size_t& = 1u);
+
+    // Destructor
+    ~Pool();
+
+    // No copies (threads cannot be copied)
+    Pool(const Pool&) = delete;
+    Pool& operator=(const Pool&) = delete;
+
+    // Number of threads (including the calling one)
+    size_t size() const { return workers.size() + 1u; };
+
+    // Function to run tasks 0 to n - 1
+    template <typename F>
+    void run(const size_t &n, const F &task) {
+
+        // n: number of tasks
+        // task: function to call on the index of each task
+
+        // Run on the calling thread if there is nothing to share
+        if (workers.empty() || n < 2u) {
+            for (size_t i = 0u; i < n; ++i) task(i);
+            return;
+        }
+
+        // Otherwise share the tasks (without copying the function)
+        dispatch(n, &task, [](const void *f, const size_t &i) { (*static_cast<const F*>(f))(i); });
+
+    }
+
+private:
+
+    // Worker threads
+    std::vector<std::thread> workers;
+
+    // Synchronization
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+
+    // Current batch of tasks
+    const void *task;
+    void (*call)(const void*, const size_t&);
+    size_t ntasks;
+    std::atomic<size_t> next;
+
+    // Bookkeeping
+    size_t batch;
+    size_t busy;
+    bool stop;
+
+    // Internal functions
+    void dispatch(const size_t&, const void*, void (*)(const void*, const size_t&));
+    void work();
+    void pick();
+
+};
+
+#endif
@@ -4,8 +4,10 @@
 
 // Constructor
 Population::Population(const Parameters &pars) :
-    individuals(std::make_unique<std::vector<Individual> >()),
-    newborns(std::make_unique<std::vector<Individual> >()),
+    individuals(std::make_unique<Storage>(pars.delta)),
+    newborns(std::make_unique<Storage>(pars.delta)),
+    classes(std::make_unique<Cohorts>(pars.delta)),
+    newclasses(std::make_unique<Cohorts>(pars.delta)),
     popsize(pars.popsize),
     tradeoff(pars.tradeoff),
     alpha(pars.alpha),
@@ -19,8 +21,32 @@ Population::Population(const Parameters &pars) :
     tend(pars.tend),
     tsave(pars.tsave),
 	verbose(pars.verbose),
-    resources({{1.0, hsymmetry}, {hsymmetry, 1.0}}),
+    multinomial(pars.multinomial),
+    seed(pars.seed),
+    renormalize(pars.renormalize),
+    cohorts(pars.cohorts),
+    prefetch(pars.prefetch),
+    blocksize(pars.blocksize),
+    speculate(pars.speculate),
+    resources({{{1.0, hsymmetry}, {hsymmetry, 1.0}}}),
+    thresholds({
+        ind::thresholds(alpha, beta, resources[0u][0u], resources[0u][1u]),
+        ind::thresholds(alpha, beta, resources[1u][0u], resources[1u][1u])
+    }),
+    regime(pop::classify(alpha, beta, hsymmetry)),
     sampleMutation(rnd::normal(0.0, mutsdev)),
+    sampleParent(rnd::Alias(cohorts ? 0u : popsize)),
+    fitnesses(std::vector<utl::Real>(cohorts ? 0u : popsize)),
+    indices(std::vector<size_t>(cohorts ? 0u : popsize)),
+    queues({std::vector<uint32_t>(), std::vector<uint32_t>()}),
+    partials(std::vector<stat::Sums>(cohorts ? 0u : (popsize + pop::grain - 1u) / pop::grain)),
+    offsets(std::vector<std::array<size_t, 2u>>(partials.size())),
+    decisions(std::vector<pop::Decision>(cohorts ? 0u : std::min(pars.blocksize > 1u ? pars.blocksize : pars.speculate ? pars.nthreads * pop::grain : 0u, popsize))),
+    split(popsize),
+    feeders({pop::Feeders(), pop::Feeders()}),
+    gains({pop::Gains(), pop::Gains()}),
+    urns({rnd::Urn(), rnd::Urn()}),
+    pool(pars.nthreads),
     time(0u)
 {
 
@@ -29,20 +55,41 @@ Population::Population(const Parameters &pars) :
     // Check
     check();
 
-    // Reserve space for the population
+    // If individuals are to be stored as classes...
+    if (cohorts) {
+
+        // Everybody starts out identical
+        classes->add(pars.xstart, false, popsize, tradeoff);
+
+        // Check
+        assert(classes->size() == 1u);
+        assert(classes->total() == popsize);
+
+        return;
+
+    }
+
+    // Reserve space for the population and its offspring
     individuals->reserve(popsize);
-    newborns->reserve(0u);
+    newborns->reserve(popsize);
 
     // Check
     assert(individuals->capacity() == popsize);
-    assert(newborns->capacity() == 0u);
+    assert(newborns->capacity() == popsize);
 
-    // Fill the population with individuals
+    // Make room for the queues of each habitat if they are to be fed in parallel
+    if (pool.size() > 1u) {
+        queues[0u].reserve(popsize);
+        queues[1u].reserve(popsize);
+    }
+
+    // Fill the population with individuals (all in the first habitat)
     for (size_t i = 0u; i < popsize; ++i) 
-        individuals->emplace_back(Individual(pars.xstart, tradeoff));
+        individuals->add(Individual(pars.xstart, tradeoff));
 
     // Check
     assert(individuals->size() == popsize);
+    assert(split == popsize);
     assert(newborns->empty());
 
 }
@@ -57,6 +104,7 @@ void Population::check() const {
     assert(delta >= 0.0);
     assert(hsymmetry >= 0.0 && hsymmetry <= 1.0);
     assert(nrounds > 0u);
+    assert(popsize <= UINT32_MAX);
     assert(mutrate >= 0.0 && mutrate <= 1.0);
     assert(mutsdev >= 0.0);
     assert(dispersal >= 0.0 && dispersal <= 1.0);
@@ -119,12 +167,152 @@ double pop::fitness(const double &rdiscov, const double &eff, const double &sume
 
 }
 
+// Function to tell which feeding kernel suits the parameters
+pop::Regime pop::classify(const double &alpha, const double &beta, const double &hsymmetry) {
+
+	// alpha: resource abundance weight
+	// beta: resource choice accuracy
+	// hsymmetry: habitat symmetry parameter
+
+	// Note: the regimes are checked from the one that saves the most work.
+
+	// Choices are fair coin flips (no need for expected fitnesses)
+	if (beta == 0.0 && alpha == 0.0) return pop::coinflip;
+
+	// The best resource is always chosen (no need for a random draw unless there is a tie)
+	if (beta == 1.0) return pop::accurate;
+
+	// Each habitat only has one of the resources (no need to look at the other one)
+	if (hsymmetry == 0.0) return pop::onesided;
+
+	return pop::generic;
+
+}
+
+// Function to add the realized fitness of feeders on the resources they chose to their fitness
+RESCHOICE_CLONES
+void pop::reward(const Storage &storage, const size_t &first, const size_t &last, const Gains &gain, std::vector<utl::Real> &fitnesses) {
+
+	// storage: the individuals
+	// first, last: range of individuals (all in the habitat of the outcome)
+	// gain: outcome of the feeding round in the habitat
+	// fitnesses: fitnesses of the individuals
+
+	// Note: this gives the same values as pop::fitness, but is written without
+	// branches or lookups depending on each individual's choice (only selections
+	// between two values), so it can be vectorized. Shares are computed in double
+	// precision whatever the precision of storage (see utl::Real), as they are when
+	// fitness is collected during the feeding rounds.
+
+	// Check
+	assert(last <= storage.size());
+	assert(last <= fitnesses.size());
+
+	// Whether each resource has feeders with positive efficiencies
+	const bool some1 = gain.sumeffs[0u] != 0.0;
+	const bool some2 = gain.sumeffs[1u] != 0.0;
+
+	// Denominators of the shares of the resources (never zero, see below)
+	const double den1 = some1 ? gain.sumeffs[0u] : 1.0;
+	const double den2 = some2 ? gain.sumeffs[1u] : 1.0;
+
+	// Shares of the resources when they are split equally (see pop::fitness)
+	const double even1 = gain.n[0u] ? gain.discovered[0u] * 1.0 / gain.n[0u] : 0.0;
+	const double even2 = gain.n[1u] ? gain.discovered[1u] * 1.0 / gain.n[1u] : 0.0;
+
+	// Direct access to the fitnesses
+	utl::Real *fits = fitnesses.data();
+
+	// For each individual...
+	for (size_t i = first; i < last; ++i) {
+
+		// Read the choice made and the corresponding feeding efficiency
+		const bool choice = storage.getChoice(i);
+		const double eff = choice ? storage.getEff2(i) : storage.getEff1(i);
+
+		// Share of the resource proportional to efficiency
+		const double share = (choice ? gain.discovered[1u] : gain.discovered[0u]) * eff / (choice ? den2 : den1);
+
+		// Add the realized fitness on the chosen resource
+		fits[i] += (choice ? some2 : some1) ? share : (choice ? even2 : even1);
+
+	}
+}
+
+// Function to add up the statistics of the adults in a range of one habitat
+RESCHOICE_CLONES
+void stat::accumulate(Sums &sums, const Storage &storage, const size_t &first, const size_t &last, const bool &habitat) {
+
+	// sums: habitat- and ecotype-specific statistics to add to
+	// storage: the individuals
+	// first, last: range of individuals (all in the given habitat)
+	// habitat: their habitat
+
+	// Note: the sums are split into a fixed number of partial sums, each individual
+	// going into one depending on its position, and those are added up at the end.
+	// This order does not depend on whether the loop is vectorized, or how.
+
+	// Check
+	assert(first <= last);
+	assert(last <= storage.size());
+
+	// Partial sums and sums of squares of trait values of each ecotype
+	std::array<std::array<double, simd::lanes>, 2u> sumx = {};
+	std::array<std::array<double, simd::lanes>, 2u> ssqx = {};
+
+	// Partial counts of the second ecotype
+	std::array<size_t, simd::lanes> n2 = {};
+
+	// Function to add an individual to the partial sums
+	auto add = [&](const size_t &i, const size_t &k) {
+
+		// i: index of the individual
+		// k: partial sum
+
+		// Check
+		assert(storage.getHabitat(i) == habitat);
+
+		// Read relevant individual metrics
+		const double x = storage.getX(i);
+		const bool ecotype = storage.getEcotype(i);
+
+		// Update the partial sums of the ecotype (and add zero to the other)
+		n2[k] += ecotype;
+		sumx[0u][k] += ecotype ? 0.0 : x;
+		sumx[1u][k] += ecotype ? x : 0.0;
+		ssqx[0u][k] += ecotype ? 0.0 : utl::sqr(x);
+		ssqx[1u][k] += ecotype ? utl::sqr(x) : 0.0;
+
+	};
+
+	// Go through whole groups of individuals, one in each partial sum...
+	size_t i = first;
+	for (; i + simd::lanes <= last; i += simd::lanes)
+		for (size_t k = 0u; k < simd::lanes; ++k) add(i + k, k);
+
+	// ... and then through whoever is left
+	for (size_t k = 0u; i < last; ++i, ++k) add(i, k);
+
+	// Add up the partial sums, in order
+	for (size_t k = 0u; k < simd::lanes; ++k) {
+		sums.n[habitat][1u] += n2[k];
+		for (size_t e = 0u; e < 2u; ++e) {
+			sums.sumx[habitat][e] += sumx[e][k];
+			sums.ssqx[habitat][e] += ssqx[e][k];
+		}
+	}
+
+	// Count the first ecotype
+	sums.n[habitat][0u] += last - first - std::accumulate(n2.begin(), n2.end(), size_t(0u));
+
+}
+
 // Function to compute the trait standard deviation
 double stat::sdev(
 	
-	const std::vector<std::vector<size_t> > &n,
-	const std::vector<std::vector<double> > &sumx,
-	const std::vector<std::vector<double> > &ssqx
+	const utl::Matrix<size_t> &n,
+	const utl::Matrix<double> &sumx,
+	const utl::Matrix<double> &ssqx
 	
 ) {
 
@@ -154,9 +342,9 @@ double stat::sdev(
 // Function to compute the ecological isolation statistic
 double stat::ei(
 	
-	const std::vector<std::vector<size_t> > &n,
-	const std::vector<std::vector<double> > &sumx,
-	const std::vector<std::vector<double> > &ssqx
+	const utl::Matrix<size_t> &n,
+	const utl::Matrix<double> &sumx,
+	const utl::Matrix<double> &ssqx
 	
 ) {
 
@@ -213,7 +401,7 @@ double stat::ei(
 }
 
 // Function to compute the spatial isolation statistic
-double stat::si(const std::vector<std::vector<size_t> > &n) {
+double stat::si(const utl::Matrix<size_t> &n) {
 
     // Different components of the statistic
 	const size_t n11 = n[0u][0u];
@@ -245,237 +433,747 @@ double stat::si(const std::vector<std::vector<size_t> > &n) {
 
 }
 
-// Function to perform one step of the life cycle
-void Population::cycle(Printer &print) {
+// Function for a feeder to choose a resource, given those ahead of it in the queue
+template <pop::Regime regime, bool record>
+bool Population::forage(const pop::Feeder &feeder, rnd::Philox &gen, double &diff) {
 
-    // print: a printer
+	// feeder: attributes of the feeder
+	// gen: random number stream of the habitat of the feeder
+	// diff: expected fitness difference (only written if recorded)
 
-	// Note:
-	// There are multiple feeding rounds.
-	// Every feeding round, individuals are taken in random order.
-	// Each individual assesses its expected fitness if feeding on each resource.
-	// That expected fitness depends on the amount of resources present, the discovery rate, 
-	// its own affinity for that resource and the cumulative affinity of all individuals
-	// feeding on that resource (i.e. having chosen that resource).
-	// Of those, the amount of resource and the discovery rate remain constant (resources
-	// are replenished every round and do not go down until everyone has made a choice),
-	// and the feeding efficiency only depends on the individual's trait value x.
-	// The cumulative affinity does change as we loop through individuals within one round
-	// though. Every time an individual makes a choice, that value changes, so we need
-	// to keep track of it. Once all individuals have chosen, the resources is split
-	// (well, only the amount of resources that was discovered). And it is split proportionately
-	// to the realized fitness of the individuals, which uses the same formula as the
-	// expected one but now with sums of feeding efficiencies being computed with everybody's values
-	// throughout all feeding rounds.
+	// Note: this only touches the feeders of the habitat of the focal one,
+	// so the two habitats can be fed from different threads.
 
-    // Flag to know if it is time to save some data
-    const bool tts = print.ison() && time % tsave == 0u;
+	// Feeders in the same habitat
+	pop::Feeders &local = feeders[feeder.habitat];
 
-    // Save time step if needed
-    if (tts) print.save("time", static_cast<double>(time));
+	// Make the feeder choose
+	const bool choice = decide<regime, record>(feeder, local, gen, diff);
 
-    // Check
-    assert(individuals->size() == popsize);
+	// And join the others on the chosen resource
+	join(feeder, choice, local);
 
-    // Initialize a vector of fitnesses
-	std::vector<double> fitnesses(popsize);
+	return choice;
 
-    // Initialize a vector of consecutive indices
-	std::vector<size_t> indices(popsize);
-	std::iota(indices.begin(), indices.end(), 0u);
+}
 
- 	// For each feeding round...
-	for (size_t j = 0u; j < nrounds; ++j) {
+// Function to compute the expected fitness of a feeder on each resource, given the feeders already in its habitat
+template <pop::Regime regime, bool record>
+std::array<double, 2u> Population::expect(const pop::Feeder &feeder, const pop::Feeders &local) const {
 
-		// Shuffle indices to take individuals in random order
-		std::shuffle(indices.begin(), indices.end(), rnd::rng);
+	// feeder: attributes of the feeder
+	// local: feeders already in the habitat of the feeder
+
+	// Note: this does not change the feeders, so many can look at the same time.
+
+	// Shortcuts
+	const bool habitat = feeder.habitat;
+	const std::array<double, 2u> &effs = feeder.effs;
+	const std::array<double, 2u> &miss = feeder.miss;
+
+	// Function to compute the expected fitness on a resource
+	auto gain = [&](const size_t &k) {
+
+		// Compute the cumulative consumption rate so far on that resource (incl. focal individual)
+		const double cumul = local.sumeffs[k] + effs[k];
+
+		// Check
+		assert(cumul >= effs[k]);
+
+		// Compute the amount of resource discovered
+		// (same as pop::discover, with the exponential of the sum kept as a product)
+		const double discov = resources[habitat][k] * (1.0 - local.left[k] * miss[k]);
 
-		// Initialize cumulative feeding efficiencies in each habitat on each resource
-		std::vector<std::vector<double> > sumeffs({{0.0, 0.0}, {0.0, 0.0}});
+		// Check that the resource discovery function is indeed saturating
+		assert(discov >= 0.0);
+		assert(discov <= resources[habitat][k]);
 
-		// Initialize other useful containers
-		std::vector<std::vector<size_t> > n({{0u, 0u}, {0u, 0u}});
-		std::vector<std::vector<double> > sumx({{0.0, 0.0}, {0.0, 0.0}}); 
+		// Compute expected fitness (special case when denominator is zero)
+		const double fit = pop::fitness(discov, effs[k], cumul, local.n[k] + 1u);
 
-		// For each individual...
-		for (size_t i = 0u; i < popsize; ++i) {        
+		// Check that expected fitness is above zero
+		assert(fit >= 0.0);
 
-			// Respect random order
-			const size_t ii = indices[i];
+		return fit;
 
-            // Isolate focal individual
-            Individual& ind = (*individuals)[ii];
+	};
 
-			// Assign a rank in the queue to the individual
-			ind.setRank(i);
+	// Expected fitness on each resource
+	std::array<double, 2u> fits = {0.0, 0.0};
 
-			// Read individual properties
-			const double x = ind.getX();
-			const bool habitat = ind.getHabitat();
+	// Compute them unless choices are made at random and they are not recorded
+	if constexpr (regime != pop::coinflip || record) {
 
-			// Get feeding efficiency on each resource
-			const std::vector<double> effs({ ind.getEff1(), ind.getEff2() });
+		// If each habitat only has one resource, nothing is to be found on the other one
+		if constexpr (regime == pop::onesided) {
+			if (habitat) fits[1u] = gain(1u); else fits[0u] = gain(0u);
+		} else {
+			fits[0u] = gain(0u);
+			fits[1u] = gain(1u);
+		}
+	}
+
+	return fits;
+
+}
+
+// Function for a feeder to choose a resource, given the feeders already in its habitat
+template <pop::Regime regime, bool record>
+bool Population::decide(const pop::Feeder &feeder, const pop::Feeders &local, rnd::Philox &gen, double &diff) const {
+
+	// feeder: attributes of the feeder
+	// local: feeders already in the habitat of the feeder
+	// gen: random number stream to draw from
+	// diff: expected fitness difference (only written if recorded)
+
+	// Note: this does not change the feeders, so many can decide at the same time.
+
+	// Expected fitness on each resource
+	const std::array<double, 2u> fits = expect<regime, record>(feeder, local);
+	const double &fit1 = fits[0u];
+	const double &fit2 = fits[1u];
+
+	// Record expected fitness difference if needed
+	if constexpr (record) diff = fit2 - fit1;
+
+	// Make the feeder choose (drawing random numbers only when needed)
+	bool choice;
+	if constexpr (regime == pop::coinflip)
+		choice = gen.flip();
+	else if constexpr (regime == pop::accurate)
+		choice = fit1 == fit2 ? gen.flip() : fit2 > fit1;
+	else
+		choice = ind::choose(fit1, fit2, thresholds[feeder.habitat], rnd::uniform(0.0, 1.0)(gen));
+
+	return choice;
+
+}
+
+// Function for a feeder to choose a resource with random numbers drawn beforehand
+template <pop::Regime regime>
+bool Population::pick(const bool &habitat, const std::array<double, 2u> &fits, const pop::Draw &draw) const {
 
-			// Compute the cumulative consumption rates so far on each resource (incl. focal individual)		
-			const double cumul1 = sumeffs[habitat][0u] + effs[0u];
-			const double cumul2 = sumeffs[habitat][1u] + effs[1u];
+	// habitat: habitat of the feeder
+	// fits: expected fitness on each resource
+	// draw: random numbers of the feeder
 
-			// Check
-			assert(cumul1 >= effs[0u]);
-			assert(cumul2 >= effs[1u]);
+	// Same rules as in decide
+	if constexpr (regime == pop::coinflip)
+		return draw.coin;
+	else if constexpr (regime == pop::accurate)
+		return fits[0u] == fits[1u] ? draw.coin : fits[1u] > fits[0u];
+	else
+		return ind::choose(fits[0u], fits[1u], thresholds[habitat], draw.u);
 
-			// Compute the amount of resource discovered for each resource
-			const double discov1 = pop::discover(resources[habitat][0u], delta, cumul1);
-			const double discov2 = pop::discover(resources[habitat][1u], delta, cumul2);
+}
+
+// Function to tell whether random numbers drawn beforehand decide the choice of a feeder on their own
+template <pop::Regime regime>
+bool Population::settled(const bool &habitat, const pop::Draw &draw) const {
+
+	// habitat: habitat of the feeder
+	// draw: random numbers of the feeder
+
+	// Random choices never depend on the other feeders...
+	if constexpr (regime == pop::coinflip) return true;
 
-			// Check
-			assert(discov1 >= 0.0);
-			assert(discov2 >= 0.0);
+	// ... while perfectly accurate ones always do
+	if constexpr (regime == pop::accurate) return false;
 
-			// Check that the resource discovery function is indeed saturating
-			assert(discov1 <= resources[habitat][0u]);
-			assert(discov2 <= resources[habitat][1u]);
+	// Otherwise a draw below (or above) all the probabilities of choosing resource 2 decides either way
+	const ind::Thresholds &probs = thresholds[habitat];
+	return draw.u < std::min({probs[0u], probs[1u], probs[2u]}) || draw.u >= std::max({probs[0u], probs[1u], probs[2u]});
 
-			// Compute expected fitness on each resource (special case when denominator is zero)
-			const double fit1 = pop::fitness(discov1, effs[0u], cumul1, n[habitat][0u] + 1u);
-			const double fit2 = pop::fitness(discov2, effs[1u], cumul2, n[habitat][1u] + 1u);
+}
+
+// Function to add a feeder to those on the resource it has chosen
+void Population::join(const pop::Feeder &feeder, const bool &choice, pop::Feeders &local) const {
 
-			// Check that expected fitnesses are above zero
-			assert(fit1 >= 0.0);
-			assert(fit2 >= 0.0);
+	// feeder: attributes of the feeder
+	// choice: resource chosen
+	// local: feeders in the habitat of the feeder
 
-			// Record expected fitness difference
-			ind.setDiff(fit2 - fit1);
+	// Shortcuts
+	const std::array<double, 2u> &effs = feeder.effs;
+	const std::array<double, 2u> &miss = feeder.miss;
 
-			// Make the individual choose
-			ind.makeChoice(fit1, fit2, alpha, beta, resources[habitat][0u], resources[habitat][1u]);
+	// Update cumulative feeding efficiencies depending on what resource has been chosen, in that habitat
+	local.sumeffs[choice] += effs[choice];
 
-			// Read the choice that was made
-			const bool choice = ind.getChoice();
+	// Update the fraction of that resource left undiscovered
+	local.left[choice] *= miss[choice];
+	if (local.left[choice] < pop::negligible) local.left[choice] = 0.0;
 
-			// Update cumulative feeding efficiencies depending on what resource has been chosen, in that habitat
-			sumeffs[habitat][choice] += effs[choice];
+	// Update other important statistics
+	++local.n[choice];
+	local.sumx[choice] += feeder.x;
 
-			// Update other important statistics
-			++n[habitat][choice];
-			sumx[habitat][choice] += x;
+	// Every now and then, recompute the fractions left undiscovered exactly (to bound rounding drift)
+	if (renormalize && ++local.since == renormalize) {
 
+		for (size_t k = 0u; k < 2u; ++k) {
+			local.left[k] = exp(-delta * local.sumeffs[k]);
+			if (local.left[k] < pop::negligible) local.left[k] = 0.0;
 		}
 
-		// Save the number and mean trait values of individuals feeding on each resource in each habitat if needed
-		if (tts) {
-			for (size_t i = 0u; i < 2u; ++i) {
-				for (size_t k = 0u; k < 2u; ++k) {
-					print.save("resourceCensus", static_cast<double>(n[i][k]));
-					print.save("resourceMeanTraitValue", n[i][k] ? sumx[i][k] / n[i][k] : 0.0);
-				}
-			}
+		local.since = 0u;
+
+	}
+}
+
+// Function to make the individual at a given position in the queue choose a resource
+template <pop::Regime regime, bool record>
+void Population::feed(const size_t &i, const size_t &j, rnd::Philox &gen) {
+
+	// i: position in the queue
+	// j: feeding round
+	// gen: random number stream of the habitat of the individual
+
+	// Get the individual ready to feed
+	const pop::Feeder feeder = prepare<record>(i, j);
+
+	// Make the individual choose
+	double diff = 0.0;
+	const bool choice = forage<regime, record>(feeder, gen, diff);
+
+	// Record expected fitness difference if needed
+	if constexpr (record) individuals->setDiff(indices[i], diff);
+
+	// Record the choice that was made
+	individuals->setChoice(indices[i], choice);
+
+}
+
+// Function to get the individual at a given position in the queue ready to feed
+template <bool record>
+pop::Feeder Population::prepare(const size_t &i, const size_t &j) {
+
+	// i: position in the queue
+	// j: feeding round
+
+	// Note: this only touches the individual itself.
+
+	// Respect random order
+	const size_t ii = indices[i];
+
+	// Assign a rank in the queue to the individual
+	individuals->setRank(ii, i);
+
+	// Read the individual properties relevant to feeding (the habitat follows from the position)
+	const pop::Feeder feeder = {
+		individuals->getX(ii),
+		{ individuals->getEff1(ii), individuals->getEff2(ii) },
+		{ individuals->getMiss1(ii), individuals->getMiss2(ii) },
+		ii >= split
+	};
+
+	// Check
+	assert(feeder.habitat == individuals->getHabitat(ii));
+
+	// Collect the realized fitness of the previous round on the way, if not done separately (see generation)
+	if constexpr (!record) {
+		if (j) {
+			const bool last = individuals->getChoice(ii);
+			const pop::Gains &gain = gains[feeder.habitat];
+			fitnesses[ii] += pop::fitness(gain.discovered[last], feeder.effs[last], gain.sumeffs[last], gain.n[last]);
 		}
+	}
+
+	return feeder;
+
+}
+
+// Function to start loading what feeding will need to know about an individual into the cache
+template <bool record>
+void Population::ready(const size_t &i) const {
+
+	// i: index of the individual
+
+	// Attributes of the individual
+	individuals->prefetch(i);
+
+	// Its fitness too, if realized fitness is added up during feeding (see generation)
+#if defined(__GNUC__)
+	if constexpr (!record) __builtin_prefetch(&fitnesses[i], 1);
+#endif
+
+}
+
+// Function to make everyone in the queue choose a resource during a feeding round
+template <pop::Regime regime, bool record>
+void Population::feedRound(const size_t &j) {
+
+	// j: feeding round
+
+	// Reset the feeders in each habitat
+	feeders = {pop::Feeders(), pop::Feeders()};
+
+	// Go through the queue block by block instead if asked to (approximation)
+	if (blocksize > 1u) {
+		feedBlocks<regime, record>(j);
+		return;
+	}
+
+	// Or guess ahead across threads if asked to (exact)
+	if (speculate) {
+		feedAhead<regime, record>(j);
+		return;
+	}
+
+	// Each habitat draws its choices from its own random number stream
+	std::array<rnd::Philox, 2u> gens = {
+		rnd::Philox(seed, time, pop::feeding, 2u * j),
+		rnd::Philox(seed, time, pop::feeding, 2u * j + 1u)
+	};
+
+	// Note: individuals only depend on those ahead of them in the queue
+	// that are in the same habitat, and each habitat uses its own stream,
+	// so feeding the habitats one after the other or at the same time
+	// gives the same outcome.
+
+	// If there are threads to share the work with...
+	if (pool.size() > 1u) {
+
+		// Split the queue by habitat (keeping the order)
+		queues[0u].clear();
+		queues[1u].clear();
+		for (size_t i = 0u; i < popsize; ++i)
+			queues[indices[i] >= split].push_back(static_cast<uint32_t>(i));
+
+		// Feed both habitats at the same time
+		pool.run(2u, [&](const size_t &h) {
+
+			// Queue of the habitat
+			const std::vector<uint32_t> &queue = queues[h];
+
+			// For each individual in the queue...
+			for (size_t k = 0u; k < queue.size(); ++k) {
+
+				// Get someone further down the queue ready if needed
+				if (prefetch && k + prefetch < queue.size())
+					ready<record>(indices[queue[k + prefetch]]);
+
+				// Feed
+				feed<regime, record>(queue[k], j, gens[h]);
 
-		// Compute the final amounts of resources discovered in each habitat on each resource
-		std::vector<std::vector<double> > discovered({{0.0, 0.0}, {0.0, 0.0}});
-		for (size_t i = 0u; i < 2u; ++i) {
-			for (size_t k = 0u; k < 2u; ++k) {
-				discovered[i][k] = pop::discover(resources[i][k], delta, sumeffs[i][k]);
-				assert(discovered[i][k] >= 0.0);
-				assert(discovered[i][k] <= resources[i][k]);
 			}
-		}
+		});
+
+	} else {
 
-		// For each individual...
+		// Otherwise go through the whole queue...
 		for (size_t i = 0u; i < popsize; ++i) {
 
-            // Isolate focal individual
-            Individual& ind = (*individuals)[i];
+			// Get someone further down the queue ready if needed
+			if (prefetch && i + prefetch < popsize)
+				ready<record>(indices[i + prefetch]);
+
+			// Feed
+			feed<regime, record>(i, j, gens[indices[i] >= split]);
+
+		}
+	}
+}
+
+// Function to make everyone in the queue choose a resource, one block of the queue at a time
+template <pop::Regime regime, bool record>
+void Population::feedBlocks(const size_t &j) {
+
+	// j: feeding round
 
-			// Read relevant individual properties
-			const bool choice = ind.getChoice();
-			const bool habitat = ind.getHabitat();
-			const double diff = ind.getDiff();
-			const size_t rank = ind.getRank();
+	// Note:
+	// This is an approximation of the feeding round (see blocksize). The queue
+	// is cut into blocks of consecutive individuals, and everyone in a block
+	// chooses given the feeders from the blocks ahead only, as if they all
+	// arrived at the same time. Those choices do not depend on each other, so
+	// they are shared across threads. Each individual draws from its own place
+	// in the random number stream of the round (its position in the queue), so
+	// the outcome does not depend on the number of threads. The choices are then
+	// added to the feeders one after the other, in the order of the queue.
+
+	// Check
+	assert(decisions.size() == std::min(blocksize, popsize));
 
-			// Corresponding feeding efficiency
-			const double eff = choice ? ind.getEff2() : ind.getEff1();
+	// For each block...
+	for (size_t start = 0u; start < popsize; start += blocksize) {
 
-			// Compute realized fitness on the chosen resource
-			const double fit = pop::fitness(discovered[habitat][choice], eff, sumeffs[habitat][choice], n[habitat][choice]);
+		// End of the block
+		const size_t stop = std::min(start + blocksize, popsize);
 
-			// Check that the fitness is above zero
-			assert(fit >= 0.0);
+		// Number of pieces to share the block into (no smaller than needed to be worth it)
+		const size_t npieces = std::min(pool.size(), (stop - start + pop::share - 1u) / pop::share);
 
-			// Add obtained food to the vector of fitnesses
-			fitnesses[i] += fit;
+		// Make everyone in the block choose, across threads
+		pool.run(npieces, [&](const size_t &c) {
 
-			// Save a few individual properties if needed
-			if (tts) {
-						
-				print.save("individualExpectedFitnessDifference", diff);
-				print.save("individualChoice", static_cast<double>(choice));
-				print.save("individualRealizedFitness", fit);
-				print.save("individualRank", static_cast<double>(rank));
+			// Range of the piece
+			const size_t first = start + c * (stop - start) / npieces;
+			const size_t last = start + (c + 1u) * (stop - start) / npieces;
+
+			// Random number stream of the round
+			rnd::Philox gen(seed, time, pop::blocking, j);
+
+			// For each individual in the piece...
+			for (size_t i = first; i < last; ++i) {
+
+				// Get someone further down the block ready if needed
+				if (prefetch && i + prefetch < last)
+					ready<record>(indices[i + prefetch]);
+
+				// Get the individual ready to feed
+				const pop::Feeder feeder = prepare<record>(i, j);
+
+				// Move to its place in the random number stream
+				gen.seek(i);
+
+				// Make it choose
+				double diff = 0.0;
+				const bool choice = decide<regime, record>(feeder, feeders[feeder.habitat], gen, diff);
+
+				// Record expected fitness difference if needed
+				if constexpr (record) individuals->setDiff(indices[i], diff);
 
-            }
+				// Record the choice that was made
+				individuals->setChoice(indices[i], choice);
 
-			// Set individual ecotype relative to population average while we are looping through individuals
-			if (!j) ind.setEcotype((sumx[0u][0u] + sumx[0u][1u] + sumx[1u][0u] + sumx[1u][1u]) / popsize);
+				// Remember it until the end of the block
+				decisions[i - start] = {feeder, choice, pop::Draw()};
+
+			}
+		});
+
+		// Add everyone in the block to the feeders, in order
+		for (size_t i = start; i < stop; ++i)
+			join(decisions[i - start].feeder, decisions[i - start].choice, feeders[decisions[i - start].feeder.habitat]);
+
+	}
+}
+
+// Function to make everyone in the queue choose a resource, guessing ahead across threads
+template <pop::Regime regime, bool record>
+void Population::feedAhead(const size_t &j) {
+
+	// j: feeding round
+
+	// Note:
+	// This gives the same outcome as going through the queue one individual
+	// after the other, but where each individual draws from its own place in
+	// the random number stream of the round (its position in the queue, as in
+	// feedBlocks), so draws do not depend on what happened before. The queue is
+	// cut into windows of one piece per thread. First, the pieces are gone
+	// through at the same time, each speculating that the feeders ahead of it
+	// are those at the start of the window (one decision only moves the totals
+	// by one efficiency, so most guesses hold). That already does the costly
+	// part of the work (looking up individuals in random order, drawing random
+	// numbers), and leaves a compact record of each decision. The first piece
+	// started from the true feeders, so its outcome is exact. The other pieces
+	// are then checked in order, against the true feeders: the choices that the
+	// random numbers decide on their own stand, and the others are made again
+	// from the record and corrected if they changed. With one thread, there is
+	// only one piece per window and nothing to check.
+
+	// Number of pieces per window, and window size
+	const size_t npieces = pool.size();
+	const size_t width = npieces * pop::grain;
+
+	// Check
+	assert(decisions.size() == std::min(width, popsize));
+
+	// For each window...
+	for (size_t start = 0u; start < popsize; start += width) {
+
+		// End of the window
+		const size_t stop = std::min(start + width, popsize);
+
+		// Feeders at the start of the window
+		const std::array<pop::Feeders, 2u> before = feeders;
+
+		// Go through each piece, across threads
+		pool.run(npieces, [&](const size_t &c) {
+
+			// Range of the piece
+			const size_t first = std::min(start + c * pop::grain, stop);
+			const size_t last = std::min(first + pop::grain, stop);
+
+			// Guess of the feeders ahead
+			std::array<pop::Feeders, 2u> guess = before;
+
+			// Random number stream of the round
+			rnd::Philox gen(seed, time, pop::speculation, j);
+
+			// For each individual in the piece...
+			for (size_t i = first; i < last; ++i) {
+
+				// Get someone further down the piece ready if needed
+				if (prefetch && i + prefetch < last)
+					ready<record>(indices[i + prefetch]);
+
+				// Get the individual ready to feed
+				const pop::Feeder feeder = prepare<record>(i, j);
+
+				// Draw its random numbers, from its own place in the stream
+				gen.seek(i);
+				pop::Draw draw;
+				draw.u = rnd::uniform(0.0, 1.0)(gen);
+				draw.coin = gen.flip();
+
+				// Make it choose given the guess
+				const std::array<double, 2u> fits = expect<regime, record>(feeder, guess[feeder.habitat]);
+				const bool choice = pick<regime>(feeder.habitat, fits, draw);
+
+				// Record expected fitness difference if needed
+				if constexpr (record) individuals->setDiff(indices[i], fits[1u] - fits[0u]);
+
+				// Record the choice that was made
+				individuals->setChoice(indices[i], choice);
+
+				// Update the guess
+				join(feeder, choice, guess[feeder.habitat]);
+
+				// Keep a record of the decision
+				decisions[i - start] = {feeder, choice, draw};
+
+			}
+
+			// The first piece started from the true feeders, so its guess is right
+			if (!c) feeders = guess;
+
+		});
+
+		// Check the decisions of the other pieces, in order
+		for (size_t i = std::min(start + pop::grain, stop); i < stop; ++i) {
+
+			// Record of the decision
+			const pop::Decision &decision = decisions[i - start];
+			const pop::Feeder &feeder = decision.feeder;
+
+			// Feeders in its habitat
+			pop::Feeders &local = feeders[feeder.habitat];
+
+			// Choice made given the guess
+			bool choice = decision.choice;
+
+			// Make it again given the true feeders, unless it did not depend on them
+			if (record || !settled<regime>(feeder.habitat, decision.draw)) {
+
+				// Choose again
+				const std::array<double, 2u> fits = expect<regime, record>(feeder, local);
+				choice = pick<regime>(feeder.habitat, fits, decision.draw);
+
+				// Correct the expected fitness difference if needed
+				if constexpr (record) individuals->setDiff(indices[i], fits[1u] - fits[0u]);
+
+				// And the choice if the guess was wrong
+				if (choice != decision.choice) individuals->setChoice(indices[i], choice);
+
+			}
+
+			// Join the others
+			join(feeder, choice, local);
 
 		}
 	}
+}
 
-    // Create a distribution to sample parents from proportionately to fitness
-	auto sampleParent = rnd::discrete(fitnesses.begin(), fitnesses.end());
+// Function to produce one chunk of offspring
+void Population::reproduce(const size_t &c) {
 
-	// Initialize useful containers for habitat- and ecotype-specific statistics
-	std::vector<std::vector<size_t> > n({{0u, 0u}, {0u, 0u}});
-	std::vector<std::vector<double> > sumx({{0.0, 0.0}, {0.0, 0.0}});
-	std::vector<std::vector<double> > ssqx({{0.0, 0.0}, {0.0, 0.0}});
+	// c: index of the chunk
 
-    // Prepare space to welcome newborns
-    newborns->reserve(popsize);
+	// Note:
+	// Newborns are split into chunks that can be produced in parallel. Each
+	// chunk draws from its own random number stream, so the result does not
+	// depend on the number of threads. The statistics of the adults with the
+	// same indices are gathered along the way, and summed up later, as are
+	// the numbers of newborns ending up in each habitat (see settle).
+
+	// Range of individuals in the chunk
+	const size_t start = c * pop::grain;
+	const size_t stop = std::min(start + pop::grain, popsize);
 
-	// For each individual to be born...
-	for (size_t i = 0u; i < popsize; ++i) {
+	// Check
+	assert(start < stop);
 
-		// Sample parent of the current offspring (with replacement)
-		const size_t j = sampleParent(rnd::rng);
+	// Random number stream of the chunk
+	rnd::Philox gen(seed, time, pop::reproduction, c);
 
-        // Isolate the parent
-        Individual& parent = (*individuals)[j];
+	// Sample the parent of each offspring (with replacement) if not done already
+	if (!multinomial)
+		for (size_t i = start; i < stop; ++i)
+			newborns->copy(i, *individuals, sampleParent(gen));
 
-		// Add offspring to the population by cloning
-		newborns->push_back(parent);
+	// Copy of the distribution of mutations for this chunk
+	rnd::normal sampleMutation = this->sampleMutation;
 
-		// Mutate offspring if needed
-		if (rnd::bernoulli(mutrate)(rnd::rng))
-			newborns->back().mutate(sampleMutation(rnd::rng), tradeoff);
+	// Mutate the offspring that need to (skipping over those that do not)
+	rnd::successes(stop - start, mutrate, gen, [&](const size_t &k) {
+		newborns->mutate(start + k, sampleMutation(gen), tradeoff);
+	});
 
-		// The offspring has a chance to disperse
-		if (rnd::bernoulli(dispersal)(rnd::rng))
-			newborns->back().disperse();
+	// Same for the offspring that disperse
+	rnd::successes(stop - start, dispersal, gen, [&](const size_t &k) {
+		newborns->disperse(start + k);
+	});
 
-        // Isolate the adult with the same index (for data collection)
-        Individual& ind = (*individuals)[i];
+	// Count the newborns in each habitat (after dispersal)
+	std::array<size_t, 2u> &counts = offsets[c];
+	counts = {0u, 0u};
+	for (size_t i = start; i < stop; ++i) ++counts[newborns->getHabitat(i)];
 
-		// Get relevant individual metrics for the corresponding adult
-		const double x = ind.getX();
-		const bool habitat = ind.getHabitat();
-		const bool ecotype = ind.getEcotype();
-     
-		// Update habitat- and ecotype-specific statistics
-		++n[habitat][ecotype];
-		sumx[habitat][ecotype] += x;
-		ssqx[habitat][ecotype] += utl::sqr(x);
+	// Prepare to gather statistics of the adults in the chunk
+	stat::Sums &sums = partials[c];
+	sums = stat::Sums();
 
-		// Save a few individual properties of that adult if needed
-		if (tts) {
-					
-			print.save("individualHabitat", static_cast<double>(habitat));
-			print.save("individualTraitValue", x);
-			print.save("individualTotalFitness", fitnesses[i]);
-			print.save("individualEcotype", static_cast<double>(ecotype));
+	// Where the second habitat starts within the chunk
+	const size_t middle = std::clamp(split, start, stop);
+
+	// Update habitat- and ecotype-specific statistics, one habitat at a time
+	stat::accumulate(sums, *individuals, start, middle, false);
+	stat::accumulate(sums, *individuals, middle, stop, true);
+
+}
+
+// Function to move one chunk of newborns into the storage of adults, sorted by habitat
+void Population::settle(const size_t &c) {
+
+	// c: index of the chunk
+
+	// Note:
+	// The population is kept partitioned by habitat, with everyone from the
+	// first habitat first, so that loops over either habitat run through a
+	// contiguous slice (and know the habitat without reading it). Dispersal
+	// mixes the newborns up, so each chunk of newborns is scattered into place,
+	// starting from the positions of its first individual in each habitat.
+	// Those positions depend only on the numbers of newborns in each habitat
+	// in the chunks before, so the chunks can be settled in parallel and the
+	// order of the newborns within each habitat is kept.
+
+	// Range of individuals in the chunk
+	const size_t start = c * pop::grain;
+	const size_t stop = std::min(start + pop::grain, popsize);
+
+	// Check
+	assert(start < stop);
+
+	// Next position to fill in each habitat
+	std::array<size_t, 2u> next = offsets[c];
+
+	// Move each newborn to the next free position in its habitat
+	for (size_t i = start; i < stop; ++i)
+		individuals->copy(next[newborns->getHabitat(i)]++, *newborns, i);
 
+	// Check
+	assert(next[0u] <= split);
+	assert(next[1u] <= popsize);
+
+}
+
+// Function to produce offspring by sampling the number of offspring of each parent
+void Population::countOffspring() {
+
+	// Note: 
+	// This is the conditional binomial method for sampling from a multinomial
+	// distribution. Each parent in turn gets a binomial number of the offspring
+	// not yet assigned, with probability its share of the fitness not yet
+	// accounted for. The resulting offspring numbers follow the same multinomial
+	// distribution as when sampling parents one offspring at a time, but the
+	// parents are read (and the newborns written) in order.
+
+	// Random number stream for the whole pass
+	rnd::Philox gen(seed, time, pop::counting);
+
+	// Position of the next offspring
+	size_t i = 0u;
+
+	// Total fitness in the population
+	double rest = std::accumulate(fitnesses.begin(), fitnesses.end(), 0.0);
+
+	// Parents are equally likely if nobody has any fitness
+	const bool flat = !rest;
+	if (flat) rest = static_cast<double>(popsize);
+
+	// Last parent that can reproduce (takes whatever is left)
+	size_t last = popsize - 1u;
+	while (!flat && last && !fitnesses[last]) --last;
+
+	// Number of offspring not yet assigned
+	size_t left = popsize;
+
+	// For each parent, until all offspring are assigned...
+	for (size_t j = 0u; j < popsize && left; ++j) {
+
+		// Weight of the parent
+		const double w = flat ? 1.0 : fitnesses[j];
+
+		// Skip parents that cannot reproduce
+		if (!w) continue;
+
+		// Probability to be the parent of each of the remaining offspring
+		const double p = j < last && w < rest ? w / rest : 1.0;
+
+		// Number of offspring of that parent
+		const size_t k = p < 1.0 ? rnd::binomial(left, p)(gen) : left;
+
+		// Check
+		assert(k <= left);
+
+		// Add the offspring to the population by cloning the parent
+		for (size_t l = 0u; l < k; ++l) newborns->copy(i++, *individuals, j);
+
+		// Update what is left
+		left -= k;
+		rest -= w;
+
+	}
+
+	// Check
+	assert(!left);
+	assert(i == popsize);
+
+}
+
+// Function to wrap up a feeding round
+template <bool record>
+utl::Matrix<double> Population::closeRound(Printer &print) {
+
+	// print: a printer
+
+	// Save the number and mean trait values of individuals feeding on each resource in each habitat if needed
+	if constexpr (record) {
+		for (size_t i = 0u; i < 2u; ++i) {
+			for (size_t k = 0u; k < 2u; ++k) {
+				const size_t n = feeders[i].n[k];
+				print.save(print.channel(out::resourceCensus), static_cast<double>(n));
+				print.save(print.channel(out::resourceMeanTraitValue), n ? feeders[i].sumx[k] / n : 0.0);
+			}
 		}
-    }
+	}
+
+	// Compute the final amounts of resources discovered in each habitat on each resource (from the running products)
+	utl::Matrix<double> discovered = {{{0.0, 0.0}, {0.0, 0.0}}};
+	for (size_t i = 0u; i < 2u; ++i) {
+		for (size_t k = 0u; k < 2u; ++k) {
+			discovered[i][k] = resources[i][k] * (1.0 - feeders[i].left[k]);
+			assert(discovered[i][k] >= 0.0);
+			assert(discovered[i][k] <= resources[i][k]);
+		}
+	}
+
+	return discovered;
+
+}
+
+// Function to compute, save and show population-level statistics
+template <bool record>
+void Population::summarize(Printer &print, const stat::Sums &sums) {
+
+	// print: a printer
+	// sums: habitat- and ecotype-specific statistics of the adults
+
+	// Shortcuts
+	const utl::Matrix<size_t> &n = sums.n;
+	const utl::Matrix<double> &sumx = sums.sumx;
+	const utl::Matrix<double> &ssqx = sums.ssqx;
 
 	// Compute statistics
 	const double meanx = (sumx[0u][0u] + sumx[0u][1u] + sumx[1u][0u] + sumx[1u][1u]) / popsize;
@@ -484,28 +1182,28 @@ void Population::cycle(Printer &print) {
 	const double SI = stat::si(n);
 
 	// Save some population-level statistics if needed
-	if (tts) {
+	if constexpr (record) {
 
 		// Save the number and mean trait values of individuals in each habitat
 		for (size_t i = 0u; i < 2u; ++i) {
 
 			const size_t n0 = n[i][0u] + n[i][1u];
-			print.save("habitatCensus", static_cast<double>(n0));
-			print.save("habitatMeanTraitValue", n0 ? (sumx[i][0u] + sumx[i][1u]) / n0 : 0.0);
+			print.save(print.channel(out::habitatCensus), static_cast<double>(n0));
+			print.save(print.channel(out::habitatMeanTraitValue), n0 ? (sumx[i][0u] + sumx[i][1u]) / n0 : 0.0);
 
 		}
 
 		// Save ecological isolation
-		print.save("ecologicalIsolation", EI);
+		print.save(print.channel(out::ecologicalIsolation), EI);
 
 		// Save spatial isolation
-		print.save("spatialIsolation", SI);
+		print.save(print.channel(out::spatialIsolation), SI);
 
 		// Save trait mean
-		print.save("traitMean", meanx);
+		print.save(print.channel(out::traitMean), meanx);
 
 		// Save trait standard deviation
-		print.save("traitStandardDeviation", sdevx);
+		print.save(print.channel(out::traitStandardDeviation), sdevx);
 
 	}
 
@@ -519,11 +1217,237 @@ void Population::cycle(Printer &print) {
 		std::cout << "SI = " << SI << '\n';
 
 	}
+}
+
+// Function to perform one step of the life cycle
+void Population::cycle(Printer &print) {
+
+    // print: a printer
+
+    // Only record data every now and then (decided once for the whole generation)
+    const bool record = print.ison() && time % tsave == 0u;
+
+    // Go through the generation with individuals or with classes of them
+    if (cohorts)
+        record ? cohortGeneration<true>(print) : cohortGeneration<false>(print);
+    else
+        record ? generation<true>(print) : generation<false>(print);
+
+}
+
+// Function to go through one generation, recording data or not
+template <bool record>
+void Population::generation(Printer &print) {
+
+    // print: a printer
+
+	// Note:
+	// There are multiple feeding rounds.
+	// Every feeding round, individuals are taken in random order.
+	// Each individual assesses its expected fitness if feeding on each resource.
+	// That expected fitness depends on the amount of resources present, the discovery rate, 
+	// its own affinity for that resource and the cumulative affinity of all individuals
+	// feeding on that resource (i.e. having chosen that resource).
+	// Of those, the amount of resource and the discovery rate remain constant (resources
+	// are replenished every round and do not go down until everyone has made a choice),
+	// and the feeding efficiency only depends on the individual's trait value x.
+	// The cumulative affinity does change as we loop through individuals within one round
+	// though. Every time an individual makes a choice, that value changes, so we need
+	// to keep track of it. Once all individuals have chosen, the resources is split
+	// (well, only the amount of resources that was discovered). And it is split proportionately
+	// to the realized fitness of the individuals, which uses the same formula as the
+	// expected one but now with sums of feeding efficiencies being computed with everybody's values
+	// throughout all feeding rounds.
+	// Unless individual data are recorded (which needs them round by round and in order),
+	// realized fitness is not worked out in a separate pass over the population after each
+	// round, but for every individual when it is visited again during the next round (see
+	// prepare), with what is left over being settled after the last round. Only the amounts
+	// discovered, cumulative efficiencies and numbers of feeders of the previous round need
+	// to be kept for that, and fitnesses are added up in the same order, so the result is
+	// the same.
+
+    // Save time step if needed
+    if constexpr (record) print.save(print.channel(out::time), static_cast<double>(time));
+
+    // Check
+    assert(individuals->size() == popsize);
+
+    // Check
+    assert(fitnesses.size() == popsize);
+    assert(indices.size() == popsize);
+
+    // Reset the fitnesses
+	std::fill(fitnesses.begin(), fitnesses.end(), 0.0);
+
+    // Reset the queue to consecutive indices
+	std::iota(indices.begin(), indices.end(), 0u);
+
+	// Mean trait value of the population (for ecotypes, from the first round)
+	double meanx = 0.0;
+
+ 	// For each feeding round...
+	for (size_t j = 0u; j < nrounds; ++j) {
+
+		// Shuffle indices to take individuals in random order
+		std::shuffle(indices.begin(), indices.end(), rnd::rng);
+
+		// Make everyone choose a resource (with the kernel suited to the parameters)
+		switch (regime) {
+			case pop::accurate: feedRound<pop::accurate, record>(j); break;
+			case pop::coinflip: feedRound<pop::coinflip, record>(j); break;
+			case pop::onesided: feedRound<pop::onesided, record>(j); break;
+			default: feedRound<pop::generic, record>(j);
+		}
+
+		// Wrap up the feeding round
+		const utl::Matrix<double> discovered = closeRound<record>(print);
+
+		// Compute the mean trait value after the first round
+		if (!j) meanx = (feeders[0u].sumx[0u] + feeders[0u].sumx[1u] + feeders[1u].sumx[0u] + feeders[1u].sumx[1u]) / popsize;
+
+		// If individual data are not recorded, only keep what the next round needs to work out realized fitness
+		if constexpr (!record) {
+			for (size_t h = 0u; h < 2u; ++h) gains[h] = {discovered[h], feeders[h].sumeffs, feeders[h].n};
+			continue;
+		}
+
+		// For each habitat (a contiguous slice of the population)...
+		for (size_t h = 0u; h < 2u; ++h) {
+
+			// Shortcuts to what is shared by the whole habitat
+			const std::array<double, 2u> &found = discovered[h];
+			const pop::Feeders &local = feeders[h];
+
+			// For each individual in the habitat...
+			for (size_t i = h ? split : 0u; i < (h ? popsize : split); ++i) {
+
+				// Check
+				assert(individuals->getHabitat(i) == h);
+
+				// Read relevant individual properties
+				const bool choice = individuals->getChoice(i);
+				const double diff = individuals->getDiff(i);
+				const size_t rank = individuals->getRank(i);
+
+				// Corresponding feeding efficiency
+				const double eff = choice ? individuals->getEff2(i) : individuals->getEff1(i);
+
+				// Compute realized fitness on the chosen resource
+				const double fit = pop::fitness(found[choice], eff, local.sumeffs[choice], local.n[choice]);
+
+				// Check that the fitness is above zero
+				assert(fit >= 0.0);
+
+				// Add obtained food to the vector of fitnesses
+				fitnesses[i] += fit;
+
+				// Save a few individual properties if needed
+				if constexpr (record) {
+						
+					print.save(print.channel(out::individualExpectedFitnessDifference), diff);
+					print.save(print.channel(out::individualChoice), static_cast<double>(choice));
+					print.save(print.channel(out::individualRealizedFitness), fit);
+					print.save(print.channel(out::individualRank), static_cast<double>(rank));
+
+				}
+
+				// Set individual ecotype relative to population average while we are looping through individuals
+				if (!j) individuals->setEcotype(i, meanx);
+
+			}
+		}
+	}
+
+	// If not done already, settle the realized fitness of the last round
+	if constexpr (!record) {
+
+		// Add the realized fitness on the chosen resource, in each habitat
+		pop::reward(*individuals, 0u, split, gains[0u], fitnesses);
+		pop::reward(*individuals, split, popsize, gains[1u], fitnesses);
+
+		// Set individual ecotypes relative to population average
+		for (size_t i = 0u; i < popsize; ++i) individuals->setEcotype(i, meanx);
+
+	}
+
+    // Check that there is room for the newborns
+    assert(newborns->empty());
+    assert(newborns->capacity() >= popsize);
+
+	// Make space for them
+	newborns->resize(popsize);
+
+	// Produce offspring proportionately to fitness, either by sampling the
+	// parent of each offspring (in parallel, see below) or by sampling the
+	// number of offspring of each parent (in one go, here)
+	if (multinomial) countOffspring(); else sampleParent.build(fitnesses);
+
+	// Check
+	assert(newborns->size() == popsize);
+	assert(partials.size() == (popsize + pop::grain - 1u) / pop::grain);
+
+	// Produce the newborns chunk by chunk, across threads
+	pool.run(partials.size(), [&](const size_t &c) { reproduce(c); });
+
+	// Add up the habitat- and ecotype-specific statistics of all chunks (in order)
+	stat::Sums sums;
+	for (const stat::Sums &part : partials) {
+		for (size_t i = 0u; i < 2u; ++i) {
+			for (size_t k = 0u; k < 2u; ++k) {
+				sums.n[i][k] += part.n[i][k];
+				sums.sumx[i][k] += part.sumx[i][k];
+				sums.ssqx[i][k] += part.ssqx[i][k];
+			}
+		}
+	}
+
+	// Save a few individual properties of the adults if needed
+	if constexpr (record) {
+
+		// Their channels
+		const size_t habitat = print.channel(out::individualHabitat);
+		const size_t trait = print.channel(out::individualTraitValue);
+		const size_t total = print.channel(out::individualTotalFitness);
+		const size_t ecotype = print.channel(out::individualEcotype);
+
+		// Skip the whole loop if none of them is
+		const bool any = print.saves(habitat) || print.saves(trait) || print.saves(total) || print.saves(ecotype);
+
+		for (size_t i = 0u; i < popsize && any; ++i) {
+					
+			print.save(habitat, static_cast<double>(individuals->getHabitat(i)));
+			print.save(trait, individuals->getX(i));
+			print.save(total, fitnesses[i]);
+			print.save(ecotype, static_cast<double>(individuals->getEcotype(i)));
+
+		}
+	}
 
-    // Newborns become adults
-    std::swap(individuals, newborns);
+	// Compute, save and show population-level statistics
+	summarize<record>(print, sums);
+
+	// Turn the numbers of newborns in each habitat in each chunk into the
+	// positions where the chunks start filling each habitat (see settle)
+	std::array<size_t, 2u> total = {0u, 0u};
+	for (std::array<size_t, 2u> &counts : offsets) {
+		for (size_t h = 0u; h < 2u; ++h) {
+			const size_t n = counts[h];
+			counts[h] = total[h];
+			total[h] += n;
+		}
+	}
 
-    // No more newborns (adults die) 
+	// Check
+	assert(total[0u] + total[1u] == popsize);
+
+	// The second habitat starts where the first one ends
+	split = total[0u];
+	for (std::array<size_t, 2u> &counts : offsets) counts[1u] += split;
+
+    // Newborns replace the adults (who die), sorted by habitat, across threads
+	pool.run(offsets.size(), [&](const size_t &c) { settle(c); });
+
+    // No more newborns
     newborns->clear();
 
     // Check
@@ -532,4 +1456,267 @@ void Population::cycle(Printer &print) {
 	// Make sure population size has not changed
 	assert(individuals->size() == popsize);
     
-}
\ No newline at end of file
+}
+
+// Function to make every member of the classes in a habitat choose a resource
+template <pop::Regime regime>
+void Population::feedCohorts(const size_t &first, const size_t &last, rnd::Philox &gen) {
+
+	// first, last: range of classes in the habitat
+	// gen: random number stream of the habitat
+
+	// Note: drawing members out of an urn without replacement gives the classes
+	// of the individuals of the habitat in the order of a shuffled queue.
+
+	// Check
+	assert(first <= last);
+	assert(last <= classes->size());
+
+	// Nothing to do if the habitat is empty
+	if (first == last) return;
+
+	// Put everyone in the urn
+	rnd::Urn &urn = urns[(*classes)[first].habitat];
+	urn.clear();
+	for (size_t c = first; c < last; ++c) urn.add((*classes)[c].count);
+	urn.build();
+
+	// No need to draw if there is only one class
+	const bool single = last - first == 1u;
+
+	// Expected fitness difference (not recorded)
+	double diff = 0.0;
+
+	// Until everyone has chosen...
+	for (size_t m = urn.total(); m; --m) {
+
+		// Class of the next individual in the queue
+		Cohort &cohort = (*classes)[single ? first : first + urn(gen)];
+
+		// Attributes of its members relevant to feeding
+		const pop::Feeder feeder = {
+			cohort.x,
+			{ cohort.eff1, cohort.eff2 },
+			{ cohort.miss1, cohort.miss2 },
+			cohort.habitat
+		};
+
+		// Make the individual choose and keep count
+		++cohort.chosen[forage<regime, false>(feeder, gen, diff)];
+
+	}
+}
+
+// Function to make every member of every class choose a resource during a feeding round
+template <pop::Regime regime>
+void Population::cohortRound(const size_t &j, const size_t &split) {
+
+	// j: feeding round
+	// split: first class in the second habitat
+
+	// Reset the feeders in each habitat
+	feeders = {pop::Feeders(), pop::Feeders()};
+
+	// Reset the numbers of members of each class feeding on each resource
+	for (size_t c = 0u; c < classes->size(); ++c) (*classes)[c].chosen = {0u, 0u};
+
+	// Each habitat draws its queue and choices from its own random number stream
+	std::array<rnd::Philox, 2u> gens = {
+		rnd::Philox(seed, time, pop::feeding, 2u * j),
+		rnd::Philox(seed, time, pop::feeding, 2u * j + 1u)
+	};
+
+	// Feed both habitats (at the same time if there are threads to share the work with)
+	pool.run(2u, [&](const size_t &h) {
+		if (h) feedCohorts<regime>(split, classes->size(), gens[h]);
+		else feedCohorts<regime>(0u, split, gens[h]);
+	});
+
+}
+
+// Function to go through one generation with classes of identical individuals
+template <bool record>
+void Population::cohortGeneration(Printer &print) {
+
+	// print: a printer
+
+	// Note: this is the same life cycle as in generation(), except that
+	// members of a class only differ by the resources they choose. Their
+	// realized fitnesses are pooled, as all that matters for reproduction
+	// is the share of the total fitness each class gets.
+
+	// Save time step if needed
+	if constexpr (record) print.save(print.channel(out::time), static_cast<double>(time));
+
+	// Check
+	assert(classes->total() == popsize);
+	assert(newclasses->size() == 0u);
+
+	// Reset the fitnesses
+	for (size_t c = 0u; c < classes->size(); ++c) (*classes)[c].fitness = 0.0;
+
+	// Classes are sorted by habitat
+	const size_t split = classes->split();
+
+	// For each feeding round...
+	for (size_t j = 0u; j < nrounds; ++j) {
+
+		// Make everyone choose a resource (with the kernel suited to the parameters)
+		switch (regime) {
+			case pop::accurate: cohortRound<pop::accurate>(j, split); break;
+			case pop::coinflip: cohortRound<pop::coinflip>(j, split); break;
+			case pop::onesided: cohortRound<pop::onesided>(j, split); break;
+			default: cohortRound<pop::generic>(j, split);
+		}
+
+		// Wrap up the feeding round
+		const utl::Matrix<double> discovered = closeRound<record>(print);
+
+		// For each class...
+		for (size_t c = 0u; c < classes->size(); ++c) {
+
+			// The class
+			Cohort &cohort = (*classes)[c];
+			const bool habitat = cohort.habitat;
+
+			// For each resource...
+			for (size_t k = 0u; k < 2u; ++k) {
+
+				// Skip if nobody in the class chose it
+				if (!cohort.chosen[k]) continue;
+
+				// Compute realized fitness of each member on that resource
+				const double fit = pop::fitness(discovered[habitat][k], k ? cohort.eff2 : cohort.eff1, feeders[habitat].sumeffs[k], feeders[habitat].n[k]);
+
+				// Check that the fitness is above zero
+				assert(fit >= 0.0);
+
+				// Add obtained food to the fitness of the class
+				cohort.fitness += cohort.chosen[k] * fit;
+
+			}
+		}
+	}
+
+	// Mean trait value of the population (for ecotypes)
+	double meanx = 0.0;
+	for (size_t c = 0u; c < classes->size(); ++c) meanx += (*classes)[c].count * (*classes)[c].x;
+	meanx /= popsize;
+
+	// Compute habitat- and ecotype-specific statistics of the adults
+	stat::Sums sums;
+	for (size_t c = 0u; c < classes->size(); ++c) {
+
+		// The class
+		const Cohort &cohort = (*classes)[c];
+
+		// Ecotype of its members relative to population average
+		const bool ecotype = cohort.x > meanx;
+
+		// Add up
+		sums.n[cohort.habitat][ecotype] += cohort.count;
+		sums.sumx[cohort.habitat][ecotype] += cohort.count * cohort.x;
+		sums.ssqx[cohort.habitat][ecotype] += cohort.count * utl::sqr(cohort.x);
+
+	}
+
+	// Produce the next generation
+	breed();
+
+	// Compute, save and show population-level statistics
+	summarize<record>(print, sums);
+
+	// Newborns become adults
+	std::swap(classes, newclasses);
+
+	// No more newborns (adults die)
+	newclasses->clear();
+
+	// Make sure population size has not changed
+	assert(classes->total() == popsize);
+
+}
+
+// Function to produce the next generation of classes
+void Population::breed() {
+
+	// Note: the numbers of offspring of each class are sampled with the
+	// conditional binomial method (see countOffspring). Among the offspring
+	// of a class, the numbers of mutants and of dispersers are binomial, and
+	// every mutant starts a class of its own. Identical classes are then pooled.
+
+	// Random number stream for the whole pass
+	rnd::Philox gen(seed, time, pop::breeding);
+
+	// Local copy of the distribution of mutations
+	std::normal_distribution<double> mutation = sampleMutation;
+
+	// Number of classes
+	const size_t m = classes->size();
+
+	// Total fitness in the population
+	double rest = 0.0;
+	for (size_t c = 0u; c < m; ++c) rest += (*classes)[c].fitness;
+
+	// Individuals are equally likely parents if nobody has any fitness
+	const bool flat = !rest;
+	if (flat) rest = static_cast<double>(popsize);
+
+	// Last class that can reproduce (takes whatever is left)
+	size_t last = m - 1u;
+	while (!flat && last && !(*classes)[last].fitness) --last;
+
+	// Number of offspring not yet assigned
+	size_t left = popsize;
+
+	// For each class, until all offspring are assigned...
+	for (size_t c = 0u; c < m && left; ++c) {
+
+		// The class
+		const Cohort &cohort = (*classes)[c];
+
+		// Weight of the class
+		const double w = flat ? static_cast<double>(cohort.count) : cohort.fitness;
+
+		// Skip classes that cannot reproduce
+		if (!w) continue;
+
+		// Probability to be the parent of each of the remaining offspring
+		const double p = c < last && w < rest ? w / rest : 1.0;
+
+		// Number of offspring of that class
+		const size_t k = p < 1.0 ? rnd::binomial(left, p)(gen) : left;
+
+		// Check
+		assert(k <= left);
+
+		// Update what is left
+		left -= k;
+		rest -= w;
+
+		// Numbers of mutants and of non-mutants that disperse
+		const size_t nmutants = rnd::binomial(k, mutrate)(gen);
+		const size_t nmovers = rnd::binomial(k - nmutants, dispersal)(gen);
+
+		// Offspring identical to their parents, in each habitat
+		newclasses->clone(cohort, cohort.habitat, k - nmutants - nmovers);
+		newclasses->clone(cohort, !cohort.habitat, nmovers);
+
+		// Mutants
+		for (size_t l = 0u; l < nmutants; ++l) {
+			const double x = cohort.x + mutation(gen);
+			const bool moves = rnd::uniform(0.0, 1.0)(gen) < dispersal;
+			newclasses->add(x, cohort.habitat != moves, 1u, tradeoff);
+		}
+	}
+
+	// Check
+	assert(!left);
+
+	// Sort the classes and pool identical ones
+	newclasses->merge();
+
+	// Check
+	assert(newclasses->total() == popsize);
+
+}
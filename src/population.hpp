@@ -2,27 +2,120 @@
 #define RESCHOICE_POPULATION_HPP
 
 // This is the header for the Population class, which encapsulates
-// a vector of Individuals and makes them go through each generation
+// the storage of individuals and makes them go through each generation
 // of the simulation.
 
 #include "printer.hpp"
 #include "parameters.hpp"
 #include "individual.hpp"
+#include "storage.hpp"
+#include "cohorts.hpp"
+#include "pool.hpp"
+#include "simd.hpp"
+
+#include <numeric>
+#include <array>
 
 namespace pop {
 
+    // Phases of the life cycle (each with their own random number streams)
+    enum Phase { reproduction = 1u, counting, feeding, breeding, blocking, speculation };
+
+    // Parameter regimes with their own feeding kernels
+    enum Regime {
+        generic,  // any parameters
+        accurate, // perfectly accurate choice (beta is one)
+        coinflip, // random choice (alpha and beta are zero)
+        onesided  // one resource per habitat (hsymmetry is zero)
+    };
+
+    // Number of individuals per chunk when splitting work across threads
+    const size_t grain = 4096u;
+
+    // Smallest number of feeders worth handing over to another thread within a block (see blocksize)
+    const size_t share = 256u;
+
+    // Fraction of a resource left undiscovered below which discovery is complete in double precision
+    // (flushing it to zero then changes nothing but keeps the running products out of subnormal numbers)
+    const double negligible = 0x1p-54;
+
+    // Attributes of an individual (or class of individuals) relevant to feeding
+    struct Feeder {
+
+        double x;                     // trait value
+        std::array<double, 2u> effs;  // feeding efficiencies
+        std::array<double, 2u> miss;  // fractions of resources left undiscovered (see Storage)
+        bool habitat;                 // habitat
+
+    };
+
+    // Random numbers drawn by a feeder ahead of its choice (see speculate)
+    struct Draw {
+
+        double u;   // uniform deviate (compared with the probabilities of choosing resource 2)
+        bool coin;  // fair coin (for random choices and ties)
+
+    };
+
+    // Choice made by a feeder that has not joined the others yet (see blocksize and speculate)
+    struct Decision {
+
+        Feeder feeder;  // attributes of the feeder
+        bool choice;    // resource chosen
+        Draw draw;      // random numbers it was chosen with (if drawn beforehand)
+
+    };
+
+    // Running totals of the feeders on each resource in one habitat during a feeding round
+    // (each habitat sits on its own cache line so habitats can be fed on different threads)
+    struct alignas(64) Feeders {
+
+        std::array<double, 2u> sumeffs = {0.0, 0.0}; // cumulative feeding efficiencies
+        std::array<size_t, 2u> n = {0u, 0u};         // numbers of feeders
+        std::array<double, 2u> sumx = {0.0, 0.0};    // sums of trait values
+        std::array<double, 2u> left = {1.0, 1.0};    // fractions of resources left undiscovered, exp(-delta * sumeffs)
+        size_t since = 0u;                           // feeders since the last exact update
+
+    };
+
+    // Outcome of a feeding round on each resource in one habitat, from which the
+    // realized fitness of the feeders can be worked out later (see generation)
+    struct Gains {
+
+        std::array<double, 2u> discovered = {0.0, 0.0}; // amounts of resources discovered
+        std::array<double, 2u> sumeffs = {0.0, 0.0};    // cumulative feeding efficiencies
+        std::array<size_t, 2u> n = {0u, 0u};            // numbers of feeders
+
+    };
+
     // Accessory functions
     double discover(const double&, const double&, const double&);
     double fitness(const double&, const double&, const double&, const size_t& = 1u);
+    Regime classify(const double&, const double&, const double&);
+
+    // Kernels (multiversioned, see simd.hpp)
+    void reward(const Storage&, const size_t&, const size_t&, const Gains&, std::vector<utl::Real>&);
 
 }
 
 namespace stat {
 
+    // Counts, sums and sums of squares of trait values in each habitat and ecotype
+    struct Sums {
+
+        utl::Matrix<size_t> n = {{{0u, 0u}, {0u, 0u}}};
+        utl::Matrix<double> sumx = {{{0.0, 0.0}, {0.0, 0.0}}};
+        utl::Matrix<double> ssqx = {{{0.0, 0.0}, {0.0, 0.0}}};
+
+    };
+
+    // Kernels (multiversioned, see simd.hpp)
+    void accumulate(Sums&, const Storage&, const size_t&, const size_t&, const bool&);
+
     // Compute statistics
-    double sdev(const std::vector<std::vector<size_t> >&, const std::vector<std::vector<double> >&, const std::vector<std::vector<double> >&);
-    double ei(const std::vector<std::vector<size_t> >&, const std::vector<std::vector<double> >&, const std::vector<std::vector<double> >&);
-	double si(const std::vector<std::vector<size_t> >&);
+    double sdev(const utl::Matrix<size_t>&, const utl::Matrix<double>&, const utl::Matrix<double>&);
+    double ei(const utl::Matrix<size_t>&, const utl::Matrix<double>&, const utl::Matrix<double>&);
+	double si(const utl::Matrix<size_t>&);
 
 }
 
@@ -45,16 +138,21 @@ public:
     bool keepon() const { return time <= tend; };
     
     // Other getters
-    size_t size() const { return individuals->size(); };
+    size_t size() const { return cohorts ? classes->total() : individuals->size(); };
     size_t getTime() const { return time; };
-    size_t getHabitat(const size_t &i) const { assert(i < individuals->size()); return (*individuals)[i].getHabitat(); };
-    double getX(const size_t &i) const { assert(i < individuals->size()); return (*individuals)[i].getX(); };
+    size_t getHabitat(const size_t &i) const { return cohorts ? (*classes)[classes->find(i)].habitat : individuals->getHabitat(i); };
+    double getX(const size_t &i) const { return cohorts ? (*classes)[classes->find(i)].x : individuals->getX(i); };
+    size_t getNClasses() const { return classes->size(); };
 
 private:
 
     // The individuals
-    std::unique_ptr<std::vector<Individual> > individuals;
-    std::unique_ptr<std::vector<Individual> > newborns;
+    std::unique_ptr<Storage> individuals;
+    std::unique_ptr<Storage> newborns;
+
+    // Or the classes of identical individuals (see cohorts)
+    std::unique_ptr<Cohorts> classes;
+    std::unique_ptr<Cohorts> newclasses;
 
     // Parameters
     size_t popsize;      // fixed population size
@@ -70,13 +168,76 @@ private:
     size_t tend;         // simulation time
     size_t tsave;        // recording time
     bool verbose;        // whether to output to screen
+    bool multinomial;    // whether to sample offspring numbers per parent
+    size_t seed;         // seed of the random number streams
+    size_t renormalize;  // number of feeders between exact updates of resource discovery
+    bool cohorts;        // whether to store classes of identical individuals
+    size_t prefetch;     // how far ahead in the feeding queue to prefetch individuals
+    size_t blocksize;    // number of feeders choosing at the same time (one for the exact model)
+    bool speculate;      // whether to feed across threads by guessing ahead
 
     // Resources in each habitat
-    std::vector<std::vector<double> > resources;
+    utl::Matrix<double> resources;
+
+    // Probabilities of choosing resource 2 in each habitat
+    std::array<ind::Thresholds, 2u> thresholds;
+
+    // Feeding kernel to use
+    pop::Regime regime;
 
     // Distribution of mutations
     std::normal_distribution<double> sampleMutation;
 
+    // Distribution of parents (rebuilt every generation)
+    rnd::Alias sampleParent;
+
+    // Scratch containers reused every generation (allocated once)
+    std::vector<utl::Real> fitnesses;
+    std::vector<size_t> indices;
+    std::array<std::vector<uint32_t>, 2u> queues;
+    std::vector<stat::Sums> partials;
+    std::vector<std::array<size_t, 2u>> offsets;
+    std::vector<pop::Decision> decisions;
+
+    // Number of individuals in the first habitat (who come first in storage)
+    size_t split;
+
+    // Feeders in each habitat during the current feeding round
+    std::array<pop::Feeders, 2u> feeders;
+
+    // Outcome of the previous feeding round in each habitat (not yet turned into fitness)
+    std::array<pop::Gains, 2u> gains;
+
+    // Queues of classes in each habitat (with cohorts)
+    std::array<rnd::Urn, 2u> urns;
+
+    // Threads to share the work with
+    Pool pool;
+
+    // Internal setters
+    template <bool> void generation(Printer&);
+    template <bool> void cohortGeneration(Printer&);
+    template <pop::Regime, bool> void feedRound(const size_t&);
+    template <pop::Regime> void cohortRound(const size_t&, const size_t&);
+    template <pop::Regime, bool> void feedBlocks(const size_t&);
+    template <pop::Regime, bool> void feedAhead(const size_t&);
+    template <pop::Regime, bool> void feed(const size_t&, const size_t&, rnd::Philox&);
+    template <bool> pop::Feeder prepare(const size_t&, const size_t&);
+    template <pop::Regime> void feedCohorts(const size_t&, const size_t&, rnd::Philox&);
+    template <pop::Regime, bool> bool forage(const pop::Feeder&, rnd::Philox&, double&);
+    template <pop::Regime, bool> std::array<double, 2u> expect(const pop::Feeder&, const pop::Feeders&) const;
+    template <pop::Regime, bool> bool decide(const pop::Feeder&, const pop::Feeders&, rnd::Philox&, double&) const;
+    template <pop::Regime> bool pick(const bool&, const std::array<double, 2u>&, const pop::Draw&) const;
+    template <pop::Regime> bool settled(const bool&, const pop::Draw&) const;
+    void join(const pop::Feeder&, const bool&, pop::Feeders&) const;
+    template <bool> void ready(const size_t&) const;
+    template <bool> utl::Matrix<double> closeRound(Printer&);
+    template <bool> void summarize(Printer&, const stat::Sums&);
+    void breed();
+    void reproduce(const size_t&);
+    void settle(const size_t&);
+    void countOffspring();
+
     // Variables
     size_t time;
     
@@ -18,18 +18,32 @@ size_t prt::memtosize(const double &m, const double &u) {
 }
 
 // Constructor
-Printer::Printer(const std::vector<std::string> &names, const double &memsave) :
+Printer::Printer(const std::vector<std::string> &names, const double &memsave, const std::vector<prt::Type> &kinds, const bool &pack) :
     memory(prt::memtosize(memsave, 1E6)),
     outputs(names),
     valids(names),
-    buffers(std::unordered_map<std::string, std::optional<Buffer> >())
+    types(kinds.empty() ? std::vector<prt::Type>(names.size(), prt::f64) : kinds),
+    compress(pack),
+    bounds(std::vector<double>(names.size(), 0.0)),
+    writer(nullptr),
+    buffers(std::vector<std::optional<Buffer> >(names.size() + 1u)),
+    channels()
 {
 
     // names: names of the output variables
     // memsave: memory use (in MB)
+    // kinds: types the output variables are written as (all doubles if empty)
+    // pack: whether to compress the outputs
 
     // Check
     assert(memory > 0u);
+    assert(types.size() == valids.size());
+
+    // Names of the outputs of the simulation
+    const std::vector<std::string> outnames = out::names();
+
+    // Look their channels up
+    for (size_t o = 0u; o < out::noutputs; ++o) channels[o] = find(outnames[o]);
 
 }
 
@@ -60,8 +74,9 @@ void Printer::read(const std::string &filename) {
 
     // filename: the name of the file to read
 
-    // Clear the list of outputs
+    // Clear the list of outputs (and their error bounds)
     outputs.clear();
+    std::fill(bounds.begin(), bounds.end(), 0.0);
 
     // Open the file
     std::ifstream file(filename.c_str());
@@ -73,9 +88,36 @@ void Printer::read(const std::string &filename) {
     // Prepare to read in requested outputs
     std::string input;
 
+    // Channel of the last output read (if it can still be given an error bound)
+    size_t last = valids.size();
+
     // For each entry...
     while (file >> input) {
 
+        // Try to read it as a number
+        std::istringstream reader(input);
+        double error;
+
+        // If it is one right after an output, it is its error bound
+        if (last < valids.size() && (reader >> error) && reader.eof()) {
+
+            // Check that the output is saved as doubles
+            if (types[last] != prt::f64)
+                throw std::runtime_error("Output " + valids[last] + " cannot be given an error bound in " + filename);
+
+            // Check that the bound is positive and finite
+            if (!(error > 0.0) || !std::isfinite(error))
+                throw std::runtime_error("Invalid error bound for output " + valids[last] + " in " + filename);
+
+            // Save it
+            bounds[last] = error;
+
+            // Only one per output
+            last = valids.size();
+            continue;
+
+        }
+
         // Check that the requested output is valid
         if (!in(input, valids))
             throw std::runtime_error("Invalid output requested in " + filename + ": " + input);
@@ -83,6 +125,9 @@ void Printer::read(const std::string &filename) {
         // Save the requested output
         outputs.push_back(input); 
 
+        // Remember its channel
+        last = find(input);
+
     }
 
     // Close the file
@@ -99,28 +144,53 @@ void Printer::open() {
     // Check
     assert(!outputs.empty());
 
+    // Start the background writer
+    if (!writer) writer = std::make_unique<Writer>();
+
     // For each output...
     for (auto &name : outputs) {
 
-        // Set up a buffer
-        buffers.emplace(name, Buffer(memory, name + ".dat"));
+        // Find its channel
+        const size_t c = find(name);
 
-        // Find the buffer
-        auto it = buffers.find(name);
-        
         // Check
-        assert(it != buffers.end());
+        assert(c < valids.size());
+
+        // Skip outputs requested twice
+        if (buffers[c]) continue;
+
+        // Set up a buffer (taking up the same memory whatever the type)
+        buffers[c].emplace(memory * prt::bits(prt::f64) / prt::bits(types[c]), name + ".dat", types[c], writer.get(), compress, bounds[c]);
 
         // Open the buffer
-        it->second->open();
+        buffers[c]->open();
 
         // Check
-        assert(it->second->isopen());
+        assert(buffers[c]->isopen());
 
     }
+}
 
-    // Check
-    assert(buffers.size() == outputs.size());
+// Function to find the handle of a channel
+size_t Printer::find(const std::string &name) const {
+
+    // name: name of the output
+
+    // Position of the name among the valid ones (the last channel if not found)
+    return std::find(valids.begin(), valids.end(), name) - valids.begin();
+
+}
+
+// Function to get the error bound of an output
+double Printer::bound(const std::string &name) const {
+
+    // name: name of the output
+
+    // Find the channel
+    const size_t c = find(name);
+
+    // Zero if it is not valid
+    return c < bounds.size() ? bounds[c] : 0.0;
 
 }
 
@@ -129,11 +199,8 @@ bool Printer::exists(const std::string &name) {
 
     // name: name of the buffer to check
 
-    // Find the buffer
-    auto it = buffers.find(name);
-
-    // Check if exists
-    return it != buffers.end();
+    // Check if the channel has a buffer
+    return saves(find(name));
 
 }
 
@@ -142,14 +209,14 @@ bool Printer::isopen(const std::string &name) {
 
     // name: name of the buffer to check
 
-    // Find the buffer
-    auto it = buffers.find(name);
+    // Find the channel
+    const size_t c = find(name);
 
     // Check
-    assert(it != buffers.end());
+    assert(saves(c));
 
     // Check if open
-    return it->second->isopen();
+    return buffers[c]->isopen();
 
 }
 
@@ -158,14 +225,14 @@ size_t Printer::capacity(const std::string &name) {
 
     // name: name of the buffer to check
 
-    // Find the buffer
-    auto it = buffers.find(name);
-    
+    // Find the channel
+    const size_t c = find(name);
+
     // Check
-    assert(it != buffers.end());
+    assert(saves(c));
 
     // Get capacity
-    return it->second->capacity();
+    return buffers[c]->capacity();
 
 }
 
@@ -175,17 +242,11 @@ void Printer::save(const std::string &name, const double &x) {
     // name: name of the buffer in which to save
     // x: value to save
 
-    // Find the buffer
-    auto it = buffers.find(name);
+    // Note: this looks the channel up every time, so prefer saving through
+    // its handle when saving many values (see find).
 
-    // Make sure it exists
-    if (it == buffers.end()) return;
-
-    // Check
-    assert(it->second->isopen());
-
-    // Save if it does
-    it->second->save(x);
+    // Save through the handle
+    save(find(name), x);
 
 }
 
@@ -198,30 +259,37 @@ void Printer::close() {
     // For each buffer...
     for (auto &buffer : buffers) {
 
-        // Close the buffer
-        buffer.second->close();
+        // Close the buffer if there is one
+        if (buffer) buffer->close();
 
     }
+
+    // Check that everything has been written
+    assert(!writer || !writer->pending());
+
 }
 
 // Function to check if all buffers are open
 bool Printer::ison() {
 
-    // Early exit if needed
-    if (buffers.empty()) return false;
-
-    // Check
-    assert(!buffers.empty());
+    // Whether any buffer was found
+    bool any = false;
 
     // For each buffer...
     for (auto &buffer : buffers) {
 
+        // Skip channels not being saved
+        if (!buffer) continue;
+
         // Exit if any is found close
-        if (!buffer.second->isopen()) return false;
+        if (!buffer->isopen()) return false;
+
+        // Remember there is one
+        any = true;
 
     }
 
-    // Otherwise say yes
-    return true;
+    // Otherwise say yes (if there are buffers at all)
+    return any;
 
 }
\ No newline at end of file
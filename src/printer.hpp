@@ -2,12 +2,27 @@
 #define RESCHOICE_PRINTER_HPP
 
 // This header is for the Printer class, which saves data to output files
-// by means of buffers.
+// by means of buffers. Each valid output is a channel, identified by its
+// position in the list of valid names. Code that saves many values should
+// look the handle of a channel up once (with find) and then save through it,
+// which costs nothing but a check when the channel is not being saved. Names
+// that are not valid map to a channel that is never saved. The handles of the
+// outputs of the simulation (see out) are looked up once and for all when the
+// printer is made, and are given by channel. Full buffers are
+// written to file in the background by a single writer thread shared by all
+// the buffers (see Writer), and everything is in the files once close returns.
+// Each valid output can be given its own type to be written as (double precision
+// floating point numbers by default, see Buffer), and all outputs can be compressed
+// (see cdc). Outputs written as doubles can be requested with an error bound, to be
+// saved as quantized values (see Buffer).
 
 #include "buffer.hpp"
+#include "outputs.hpp"
 
-#include <unordered_map>
+#include <vector>
 #include <optional>
+#include <array>
+#include <sstream>
 #include <cmath>
 
 namespace prt {
@@ -22,7 +37,7 @@ class Printer {
 public:
 
     // Constructor
-    Printer(const std::vector<std::string>&, const double& = 1.0);
+    Printer(const std::vector<std::string>&, const double& = 1.0, const std::vector<prt::Type>& = {}, const bool& = false);
 
     // Setters
     void read(const std::string&);
@@ -32,9 +47,31 @@ public:
     // Buffer setters
     void save(const std::string&, const double&);
 
+    // Function to save a value through the handle of a channel (see find)
+    void save(const size_t &c, const double &x) {
+
+        // c: handle of the channel
+        // x: value to save
+
+        // Check
+        assert(c < buffers.size());
+
+        // Save if the channel is on
+        if (buffers[c]) buffers[c]->save(x);
+
+    };
+
     // Getters
     bool ison();
 
+    // Channel getters
+    size_t find(const std::string&) const;
+
+    // Function to return the handle of the channel of an output of the simulation
+    size_t channel(const out::Output &o) const { assert(o < channels.size()); return channels[o]; };
+    double bound(const std::string&) const;
+    bool saves(const size_t &c) const { assert(c < buffers.size()); return buffers[c].has_value(); };
+
     // Buffer getters
     bool exists(const std::string&);
     bool isopen(const std::string&);
@@ -51,8 +88,23 @@ private:
     // Valid names
     std::vector<std::string> valids;
 
-    // Data buffers
-    std::unordered_map<std::string, std::optional<Buffer> > buffers;
+    // Types each valid output is written as (see Buffer)
+    std::vector<prt::Type> types;
+
+    // Whether to compress the outputs
+    bool compress;
+
+    // Error bounds of the valid outputs (zero to save them exactly)
+    std::vector<double> bounds;
+
+    // Background writer (started when buffers are opened)
+    std::unique_ptr<Writer> writer;
+
+    // Data buffers (one per valid name, plus one never used for invalid names)
+    std::vector<std::optional<Buffer> > buffers;
+
+    // Handles of the outputs of the simulation (never saved if not valid names)
+    std::array<size_t, out::noutputs> channels;
 
 };
 
@@ -5,3 +5,145 @@
 // Random number generator
 std::mt19937_64 rnd::rng;
 
+// Constructor
+rnd::Alias::Alias(const size_t &n) :
+    prob(std::vector<double>()),
+    alias(std::vector<size_t>()),
+    small(std::vector<size_t>()),
+    large(std::vector<size_t>())
+{
+
+    // n: number of weights to make room for
+
+    // Reserve space
+    reserve(n);
+
+}
+
+// Function to make room for a given number of weights
+void rnd::Alias::reserve(const size_t &n) {
+
+    // n: number of weights
+
+    prob.reserve(n);
+    alias.reserve(n);
+    small.reserve(n);
+    large.reserve(n);
+
+}
+
+// Function to (re)build the table from a set of weights
+template <typename T>
+void rnd::Alias::build(const std::vector<T> &weights) {
+
+    // weights: (non-negative) weight of each index
+
+    // Check
+    assert(!weights.empty());
+
+    // Number of columns
+    const size_t n = weights.size();
+
+    // Resize (no allocation if enough space is reserved)
+    prob.resize(n);
+    alias.resize(n);
+    small.clear();
+    large.clear();
+
+    // Total weight
+    double total = 0.0;
+    for (size_t i = 0u; i < n; ++i) {
+        assert(weights[i] >= 0.0);
+        total += weights[i];
+    }
+
+    // Sample uniformly if all weights are zero
+    const double scale = total ? n / total : 0.0;
+
+    // Scale the weights so they average to one and sort the columns
+    for (size_t i = 0u; i < n; ++i) {
+
+        // Scaled weight
+        prob[i] = total ? weights[i] * scale : 1.0;
+        alias[i] = i;
+
+        // Is the column under- or overfull?
+        if (prob[i] < 1.0) small.push_back(i); else large.push_back(i);
+
+    }
+
+    // Fill underfull columns with the excess of overfull ones
+    while (!small.empty() && !large.empty()) {
+
+        // Pick one of each
+        const size_t s = small.back();
+        const size_t l = large.back();
+        small.pop_back();
+
+        // The overfull column tops up the underfull one
+        alias[s] = l;
+        prob[l] = (prob[l] + prob[s]) - 1.0;
+
+        // Is the overfull column now underfull?
+        if (prob[l] < 1.0) {
+            large.pop_back();
+            small.push_back(l);
+        }
+    }
+
+    // Leftover columns are full (up to rounding errors)
+    for (const size_t &i : large) prob[i] = 1.0;
+    for (const size_t &i : small) prob[i] = 1.0;
+
+}
+
+// Weights in double or single precision (see utl::Real)
+template void rnd::Alias::build<double>(const std::vector<double>&);
+template void rnd::Alias::build<float>(const std::vector<float>&);
+
+// Constructor
+rnd::Urn::Urn() :
+    tree(std::vector<size_t>(1u, 0u)),
+    remaining(0u),
+    top(0u)
+{}
+
+// Function to empty the urn (capacity is kept)
+void rnd::Urn::clear() {
+
+    // Keep the unused first node
+    tree.resize(1u);
+    remaining = 0u;
+    top = 0u;
+
+}
+
+// Function to put in balls of a new kind
+void rnd::Urn::add(const size_t &count) {
+
+    // count: number of balls
+
+    // Store the count as is (see build)
+    tree.push_back(count);
+    remaining += count;
+
+}
+
+// Function to get the urn ready for drawing
+void rnd::Urn::build() {
+
+    // Note: each node adds itself to the next node covering it,
+    // which turns raw counts into partial sums in linear time.
+
+    // Turn the counts into a tree
+    for (size_t i = 1u; i < tree.size(); ++i) {
+        const size_t j = i + (i & (~i + 1u));
+        if (j < tree.size()) tree[j] += tree[i];
+    }
+
+    // Find the first step of the descent
+    top = 1u;
+    while (top * 2u <= size()) top *= 2u;
+    if (!size()) top = 0u;
+
+}
@@ -16,6 +16,13 @@
 // takes time...)
 
 #include <random>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <array>
+#include <limits>
+#include <cassert>
 
 namespace rnd
 {
@@ -35,6 +42,309 @@ namespace rnd
     // Random number generator
     extern std::mt19937_64 rng;
 
+    // Counter-based random number generator (Philox4x32-10, Salmon et al. 2011).
+    // Each output block is a pure function of a key and a counter, so a stream
+    // can be started anywhere without generating what comes before it. The key
+    // is the seed, and the counter is made of the generation, the phase of the
+    // life cycle and the chunk (e.g. a range of individuals) the stream is for,
+    // plus a position within the stream. Streams with different coordinates are
+    // independent, and the numbers a chunk gets do not depend on which thread
+    // runs it or in what order. It can be used wherever rnd::rng is used.
+    class Philox {
+
+    public:
+
+        // Types required of a random number generator
+        typedef uint64_t result_type;
+        static constexpr result_type min() { return 0u; };
+        static constexpr result_type max() { return std::numeric_limits<result_type>::max(); };
+
+        // Constructor
+        Philox(const size_t &seed, const size_t &generation = 0u, const size_t &phase = 0u, const size_t &chunk = 0u) :
+            key({static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32u)}),
+            counter({0u, static_cast<uint32_t>(chunk), static_cast<uint32_t>(phase), static_cast<uint32_t>(generation)}),
+            block({0u, 0u, 0u, 0u}),
+            used(4u),
+            position(0u),
+            coins(0u),
+            ncoins(0u)
+        {
+            // Check that the coordinates fit in the counter
+            assert(chunk <= UINT32_MAX);
+            assert(phase <= UINT32_MAX);
+            assert(generation <= UINT32_MAX);
+        }
+
+        // Function to generate the next 64 random bits
+        result_type operator()() {
+
+            // Refill when the current block is used up
+            if (used == 4u) refill();
+
+            // Combine two 32-bit words
+            const result_type lo = block[used++];
+            const result_type hi = block[used++];
+            return lo | (hi << 32u);
+
+        }
+
+        // Function to jump to the start of a given block of the stream
+        void seek(const size_t &index) {
+
+            // index: index of the block (each block holds two 64-bit outputs)
+
+            // Note: this makes it possible to give each of many items (e.g.
+            // individuals) its own numbers within one stream, whatever the
+            // order in which the items are visited.
+
+            // Check that the position fits in the counter
+            assert(index <= UINT32_MAX);
+
+            // Move there and forget what was left of the current block
+            position = index;
+            used = 4u;
+            ncoins = 0u;
+
+        }
+
+        // Function to flip a fair coin (uses one bit of output at a time)
+        bool flip() {
+
+            // Draw new bits when all have been used
+            if (!ncoins) { coins = (*this)(); ncoins = 64u; }
+
+            // Take the next bit
+            const bool bit = coins & 1u;
+            coins >>= 1u;
+            --ncoins;
+            return bit;
+
+        }
+
+        // Function to compute the output block of a key and a counter
+        static std::array<uint32_t, 4u> hash(std::array<uint32_t, 4u> ctr, std::array<uint32_t, 2u> k) {
+
+            // ctr: counter
+            // k: key
+
+            // Ten rounds of multiplications and key mixing
+            for (size_t r = 0u; r < 10u; ++r) {
+
+                // Bump the key between rounds
+                if (r) { k[0u] += 0x9E3779B9u; k[1u] += 0xBB67AE85u; }
+
+                // Wide products
+                const uint64_t p0 = static_cast<uint64_t>(0xD2511F53u) * ctr[0u];
+                const uint64_t p1 = static_cast<uint64_t>(0xCD9E8D57u) * ctr[2u];
+
+                // Mix
+                ctr = {
+                    static_cast<uint32_t>(p1 >> 32u) ^ ctr[1u] ^ k[0u],
+                    static_cast<uint32_t>(p1),
+                    static_cast<uint32_t>(p0 >> 32u) ^ ctr[3u] ^ k[1u],
+                    static_cast<uint32_t>(p0)
+                };
+            }
+
+            return ctr;
+
+        }
+
+    private:
+
+        // Key and counter
+        std::array<uint32_t, 2u> key;
+        std::array<uint32_t, 4u> counter;
+
+        // Current output block and how much of it has been used
+        std::array<uint32_t, 4u> block;
+        size_t used;
+
+        // Index of the next block (kept wider than the counter to catch overflow)
+        size_t position;
+
+        // Bits left over for coin flips
+        uint64_t coins;
+        size_t ncoins;
+
+        // Function to compute the next block
+        void refill() {
+
+            // Check that the stream is not used up (it would start over otherwise)
+            assert(position <= UINT32_MAX);
+
+            // Hash the counter
+            counter[0u] = static_cast<uint32_t>(position);
+            block = hash(counter, key);
+
+            // Move along the stream
+            ++position;
+            used = 0u;
+
+        }
+
+    };
+
+    // Function to visit the successes among n Bernoulli trials with probability p.
+    // Instead of drawing every trial, we jump from one success to the next by
+    // sampling the (geometric) number of failures in between, so the cost is
+    // proportional to the number of successes and not to the number of trials.
+    template <typename G, typename F>
+    void successes(const size_t &n, const double &p, G &gen, const F &visit) {
+
+        // n: number of trials
+        // p: probability of success
+        // gen: random number generator
+        // visit: function to call on the index of each success
+
+        // Check
+        assert(p >= 0.0 && p <= 1.0);
+
+        // Early exit if no success is possible
+        if (p <= 0.0) return;
+
+        // Every trial is a success if certain
+        if (p >= 1.0) {
+            for (size_t i = 0u; i < n; ++i) visit(i);
+            return;
+        }
+
+        // Log-probability of failure (accurate for small p)
+        const double logq = std::log1p(-p);
+
+        // Jump from success to success...
+        for (size_t i = 0u; i < n; ++i) {
+
+            // Number of failures before the next success
+            const double gap = std::floor(std::log(1.0 - uniform(0.0, 1.0)(gen)) / logq);
+
+            // Stop if we jump beyond the last trial
+            if (gap >= static_cast<double>(n - i)) return;
+
+            // Move to the success and visit it
+            i += static_cast<size_t>(gap);
+            visit(i);
+
+        }
+    }
+
+    // Alias table (Walker/Vose) to sample indices proportionately to weights.
+    // The table can be rebuilt from new weights as many times as needed without
+    // reallocating (once enough space has been reserved) and each draw takes
+    // constant time, unlike rnd::discrete, which uses a binary search.
+    class Alias {
+
+    public:
+
+        // Constructor
+        Alias(const size_t& = 0u);
+
+        // Setters
+        void reserve(const size_t&);
+        template <typename T = double> void build(const std::vector<T>&);
+
+        // Getters
+        size_t size() const { return prob.size(); };
+        size_t capacity() const { return prob.capacity(); };
+
+        // Function to sample an index
+        template <typename G>
+        size_t operator()(G &gen) const {
+
+            // gen: random number generator
+
+            // Check
+            assert(!prob.empty());
+
+            // Draw a position along the table
+            const double u = uniform(0.0, static_cast<double>(prob.size()))(gen);
+
+            // Column of the table that position falls into
+            const size_t i = std::min(static_cast<size_t>(u), prob.size() - 1u);
+
+            // Keep the column or take its alias
+            return u - i < prob[i] ? i : alias[i];
+
+        }
+
+    private:
+
+        // Probability of keeping each column and its alias otherwise
+        std::vector<double> prob;
+        std::vector<size_t> alias;
+
+        // Worklists used while building
+        std::vector<size_t> small;
+        std::vector<size_t> large;
+
+    };
+
+    // Urn with balls of several kinds, to draw balls one at a time without
+    // replacement. Counts are kept in a Fenwick (binary indexed) tree, so each
+    // draw takes a time logarithmic in the number of kinds, not in the number
+    // of balls. Drawing every ball out of the urn gives the kinds of the items
+    // of a shuffled list without having to store the list.
+    class Urn {
+
+    public:
+
+        // Constructor
+        Urn();
+
+        // Setters
+        void clear();
+        void add(const size_t&);
+        void build();
+
+        // Getters
+        size_t size() const { return tree.size() - 1u; };
+        size_t total() const { return remaining; };
+
+        // Function to draw a ball and tell its kind
+        template <typename G>
+        size_t operator()(G &gen) {
+
+            // gen: random number generator
+
+            // Check
+            assert(remaining > 0u);
+
+            // Rank of the ball among those left
+            size_t r = random(0u, remaining - 1u)(gen);
+
+            // Descend the tree to find the kind it belongs to
+            size_t i = 0u;
+            for (size_t step = top; step; step >>= 1u) {
+                if (i + step < tree.size() && tree[i + step] <= r) {
+                    i += step;
+                    r -= tree[i];
+                }
+            }
+
+            // Check
+            assert(i < size());
+
+            // Take the ball out
+            for (size_t j = i + 1u; j < tree.size(); j += j & (~j + 1u)) --tree[j];
+            --remaining;
+
+            return i;
+
+        }
+
+    private:
+
+        // Fenwick tree of the counts (starting at one)
+        std::vector<size_t> tree;
+
+        // Number of balls left
+        size_t remaining;
+
+        // Largest power of two not above the number of kinds
+        size_t top;
+
+    };
+
 }
 
 #endif
@@ -0,0 +1,37 @@
+#ifndef RESCHOICE_SIMD_HPP
+#define RESCHOICE_SIMD_HPP
+
+// This header defines a macro to mark functions (typically loops over individuals)
+// that should be compiled for several instruction sets, with the best one supported
+// by the processor picked when the program starts (function multiversioning). This
+// way, a single binary can use wide vector instructions (AVX2, AVX-512) on machines
+// that have them, and still run on any x86-64 machine. The different versions only
+// differ in how many values are processed at once, never in the order of operations
+// (no reassociation, and no fused multiply-adds, see src/CMakeLists.txt), so they give
+// the same results. Compile with RESCHOICE_NO_CLONES defined (or with a compiler or
+// platform that does not support it) to get a single, generic version.
+
+// Example usage:
+// RESCHOICE_CLONES void kernel(const size_t &n, double *x) { ... }
+
+// Versions to compile (not under ThreadSanitizer, whose runtime is not ready yet when the version is picked)
+#if !defined(RESCHOICE_NO_CLONES) && !defined(__SANITIZE_THREAD__) && defined(__GNUC__) && defined(__x86_64__) && defined(__linux__) && defined(__has_attribute)
+#if __has_attribute(target_clones)
+#define RESCHOICE_CLONES __attribute__((target_clones("default", "avx2", "avx512f")))
+#endif
+#endif
+
+// Otherwise only the generic one
+#ifndef RESCHOICE_CLONES
+#define RESCHOICE_CLONES
+#endif
+
+// Number of partial sums kept side by side in reductions (so they can be vectorized
+// without depending on the instruction set for the order in which values are added)
+namespace simd {
+
+    const size_t lanes = 8u;
+
+}
+
+#endif
@@ -0,0 +1,197 @@
+// This script contains member functions of the Storage class.
+
+#include "storage.hpp"
+
+// Constructor
+Storage::Storage(const double &rate) :
+    delta(rate),
+    x(std::vector<utl::Real>()),
+    eff1(std::vector<utl::Real>()),
+    eff2(std::vector<utl::Real>()),
+    miss1(std::vector<utl::Real>()),
+    miss2(std::vector<utl::Real>()),
+    diff(std::vector<utl::Real>()),
+    rank(std::vector<uint32_t>()),
+    habitat(std::vector<uint8_t>()),
+    ecotype(std::vector<uint8_t>()),
+    choice(std::vector<uint8_t>())
+{
+
+    // rate: resource discovery rate
+
+    // Check
+    assert(delta >= 0.0);
+
+}
+
+// Function to reserve space in every column
+void Storage::reserve(const size_t &n) {
+
+    // n: number of individuals to make room for
+
+    x.reserve(n);
+    eff1.reserve(n);
+    eff2.reserve(n);
+    miss1.reserve(n);
+    miss2.reserve(n);
+    diff.reserve(n);
+    rank.reserve(n);
+    habitat.reserve(n);
+    ecotype.reserve(n);
+    choice.reserve(n);
+
+}
+
+// Function to remove all individuals (capacity is kept)
+void Storage::clear() {
+
+    x.clear();
+    eff1.clear();
+    eff2.clear();
+    miss1.clear();
+    miss2.clear();
+    diff.clear();
+    rank.clear();
+    habitat.clear();
+    ecotype.clear();
+    choice.clear();
+
+}
+
+// Function to change the number of individuals (no allocation within capacity)
+void Storage::resize(const size_t &n) {
+
+    // n: new number of individuals
+
+    x.resize(n);
+    eff1.resize(n);
+    eff2.resize(n);
+    miss1.resize(n);
+    miss2.resize(n);
+    diff.resize(n);
+    rank.resize(n);
+    habitat.resize(n);
+    ecotype.resize(n);
+    choice.resize(n);
+
+}
+
+// Function to add an individual at the end
+void Storage::add(const Individual &ind) {
+
+    // ind: the individual to add
+
+    x.push_back(ind.x);
+    eff1.push_back(ind.eff1);
+    eff2.push_back(ind.eff2);
+    miss1.push_back(exp(-delta * ind.eff1));
+    miss2.push_back(exp(-delta * ind.eff2));
+    diff.push_back(ind.diff);
+    rank.push_back(ind.rank);
+    habitat.push_back(ind.habitat);
+    ecotype.push_back(ind.ecotype);
+    choice.push_back(ind.choice);
+
+}
+
+// Function to add a copy of an individual from another storage at the end
+void Storage::clone(const Storage &other, const size_t &j) {
+
+    // other: storage to copy from
+    // j: index of the individual to copy
+
+    // Check
+    assert(j < other.size());
+    assert(other.delta == delta);
+
+    x.push_back(other.x[j]);
+    eff1.push_back(other.eff1[j]);
+    eff2.push_back(other.eff2[j]);
+    miss1.push_back(other.miss1[j]);
+    miss2.push_back(other.miss2[j]);
+    diff.push_back(other.diff[j]);
+    rank.push_back(other.rank[j]);
+    habitat.push_back(other.habitat[j]);
+    ecotype.push_back(other.ecotype[j]);
+    choice.push_back(other.choice[j]);
+
+}
+
+// Function to overwrite an individual with a copy of an individual from another storage
+void Storage::copy(const size_t &i, const Storage &other, const size_t &j) {
+
+    // i: index of the individual to overwrite
+    // other: storage to copy from
+    // j: index of the individual to copy
+
+    // Note: this only touches position i, so different positions can be
+    // filled in from different threads.
+
+    // Check
+    assert(i < size());
+    assert(j < other.size());
+    assert(other.delta == delta);
+
+    x[i] = other.x[j];
+    eff1[i] = other.eff1[j];
+    eff2[i] = other.eff2[j];
+    miss1[i] = other.miss1[j];
+    miss2[i] = other.miss2[j];
+    diff[i] = other.diff[j];
+    rank[i] = other.rank[j];
+    habitat[i] = other.habitat[j];
+    ecotype[i] = other.ecotype[j];
+    choice[i] = other.choice[j];
+
+}
+
+// Function to read an individual back as a whole
+Individual Storage::get(const size_t &i) const {
+
+    // i: index of the individual
+
+    // Check
+    assert(i < size());
+
+    // Create an individual (efficiencies are overwritten below)
+    Individual ind(x[i], 0.0);
+
+    // Copy the attributes over
+    ind.eff1 = eff1[i];
+    ind.eff2 = eff2[i];
+    ind.diff = diff[i];
+    ind.rank = rank[i];
+    ind.habitat = habitat[i];
+    ind.ecotype = ecotype[i];
+    ind.choice = choice[i];
+
+    return ind;
+
+}
+
+// Function to mutate an individual
+void Storage::mutate(const size_t &i, const double &dx, const double &tradeoff) {
+
+    // i: index of the individual
+    // dx: phenotypic deviation
+    // tradeoff: resource utilization tradeoff
+
+    // Check
+    assert(i < size());
+
+    // Apply phenotypic deviation
+    x[i] += dx;
+
+    // Update feeding efficiencies
+    eff1[i] = ind::efficiency(x[i] + 1.0, tradeoff);
+    eff2[i] = ind::efficiency(x[i] - 1.0, tradeoff);
+
+    // Check that feeding efficiencies are still above zero
+    assert(eff1[i] >= 0.0);
+    assert(eff2[i] >= 0.0);
+
+    // Update the fractions of resources left undiscovered
+    miss1[i] = exp(-delta * eff1[i]);
+    miss2[i] = exp(-delta * eff2[i]);
+
+}
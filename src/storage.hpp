@@ -0,0 +1,113 @@
+#ifndef RESCHOICE_STORAGE_HPP
+#define RESCHOICE_STORAGE_HPP
+
+// This is the header for the Storage class, which holds a group of individuals
+// as a structure of arrays. Each attribute of the individuals is kept in its own
+// contiguous column, so loops that only need a few attributes (e.g. the feeding
+// rounds, which read efficiencies and habitats and write choices) do not have to
+// pull whole individuals into the cache. Flags are stored as bytes and ranks as
+// 32-bit integers to keep the columns narrow. Individual records can still be
+// added to and read back from the storage (e.g. in tests). The storage also caches,
+// for each individual, the fraction of each resource its own feeding effort leaves
+// undiscovered, exp(-delta * eff), so the feeding rounds can update the amounts of
+// resources discovered with a product instead of an exponential. Those factors are
+// computed when individuals are added or mutate. Attributes that are real numbers
+// are stored in utl::Real precision (see utilities.hpp).
+
+#include "individual.hpp"
+
+#include <vector>
+#include <cstdint>
+#include <cassert>
+
+class Storage {
+
+public:
+
+    // Constructor
+    Storage(const double& = 0.0);
+
+    // Setters
+    void reserve(const size_t&);
+    void clear();
+    void resize(const size_t&);
+    void add(const Individual&);
+    void clone(const Storage&, const size_t&);
+    void copy(const size_t&, const Storage&, const size_t&);
+
+    // Getter of a whole individual
+    Individual get(const size_t&) const;
+
+    // Size getters
+    size_t size() const { return x.size(); };
+    size_t capacity() const { return x.capacity(); };
+    bool empty() const { return x.empty(); };
+
+    // Attribute getters
+    utl::Real getX(const size_t &i) const { assert(i < size()); return x[i]; };
+    utl::Real getEff1(const size_t &i) const { assert(i < size()); return eff1[i]; };
+    utl::Real getEff2(const size_t &i) const { assert(i < size()); return eff2[i]; };
+    utl::Real getMiss1(const size_t &i) const { assert(i < size()); return miss1[i]; };
+    utl::Real getMiss2(const size_t &i) const { assert(i < size()); return miss2[i]; };
+    utl::Real getDiff(const size_t &i) const { assert(i < size()); return diff[i]; };
+    bool getHabitat(const size_t &i) const { assert(i < size()); return habitat[i]; };
+    bool getEcotype(const size_t &i) const { assert(i < size()); return ecotype[i]; };
+    bool getChoice(const size_t &i) const { assert(i < size()); return choice[i]; };
+    size_t getRank(const size_t &i) const { assert(i < size()); return rank[i]; };
+
+    // Attribute setters
+    void setDiff(const size_t &i, const double &value) { assert(i < size()); diff[i] = value; };
+    void setChoice(const size_t &i, const bool &value) { assert(i < size()); choice[i] = value; };
+    void setRank(const size_t &i, const size_t &value) { assert(i < size()); assert(value <= UINT32_MAX); rank[i] = static_cast<uint32_t>(value); };
+    void setEcotype(const size_t &i, const double &meanx) { assert(i < size()); ecotype[i] = x[i] > meanx; };
+    void disperse(const size_t &i) { assert(i < size()); habitat[i] = !habitat[i]; };
+
+    // Other setters
+    void mutate(const size_t&, const double&, const double&);
+
+    // Function to start loading what feeding needs to know about an individual into the cache
+    void prefetch(const size_t &i) const {
+
+        // i: index of the individual
+
+        // Note: this is only a hint to the processor (and does nothing on
+        // compilers that do not support it), so the data are not affected.
+
+        // Check
+        assert(i < size());
+
+#if defined(__GNUC__)
+        // Attributes that are read...
+        __builtin_prefetch(&x[i], 0);
+        __builtin_prefetch(&eff1[i], 0);
+        __builtin_prefetch(&eff2[i], 0);
+        __builtin_prefetch(&miss1[i], 0);
+        __builtin_prefetch(&miss2[i], 0);
+
+        // ... and written
+        __builtin_prefetch(&rank[i], 1);
+        __builtin_prefetch(&choice[i], 1);
+#endif
+
+    };
+
+private:
+
+    // Resource discovery rate
+    double delta;
+
+    // Columns of individual attributes (see Individual)
+    std::vector<utl::Real> x;
+    std::vector<utl::Real> eff1;
+    std::vector<utl::Real> eff2;
+    std::vector<utl::Real> miss1;
+    std::vector<utl::Real> miss2;
+    std::vector<utl::Real> diff;
+    std::vector<uint32_t> rank;
+    std::vector<uint8_t> habitat;
+    std::vector<uint8_t> ecotype;
+    std::vector<uint8_t> choice;
+
+};
+
+#endif
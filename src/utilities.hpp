@@ -3,9 +3,24 @@
 
 // This header contains a set of miscellaneous utility functions
 
+#include <array>
+
 namespace utl
 {
 
+    // Precision in which the attributes of individuals are stored (single precision
+    // when compiled with RESCHOICE_FLOAT defined, to halve the memory they take up;
+    // running totals and statistics are still accumulated in double precision)
+#ifdef RESCHOICE_FLOAT
+    typedef float Real;
+#else
+    typedef double Real;
+#endif
+
+    // Fixed-size container with one cell per habitat and resource (or ecotype)
+    template <typename T>
+    using Matrix = std::array<std::array<T, 2u>, 2u>;
+
     // Utility functions
     inline double sqr(const double &x) { return x * x; }
     inline double correct(const double &x) { return x < 0.0 && x > -1e-06 ? 0.0 : x; }
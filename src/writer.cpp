@@ -0,0 +1,137 @@
+// This script contains member functions of the Writer class.
+
+#include "writer.hpp"
+
+// Constructor
+Writer::Writer() :
+    jobs(std::deque<Job>()),
+    current(nullptr),
+    stop(false),
+    chunk(std::vector<uint8_t>()),
+    thread(&Writer::work, this)
+{}
+
+// Destructor
+Writer::~Writer() {
+
+    // Tell the thread to stop (after writing whatever is left)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stop = true;
+    }
+
+    // Wake it up
+    wake.notify_one();
+
+    // Wait for it to finish
+    thread.join();
+
+    // Check
+    assert(jobs.empty());
+
+}
+
+// Function to hand over a container to be written to a file
+void Writer::write(std::ofstream &file, std::vector<uint8_t> &data, const cdc::Frame &frame) {
+
+    // file: output file stream
+    // data: bytes to write (emptied once written)
+    // frame: whether and how to write them as a chunk
+
+    // Queue the container
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        // Check that it is not already waiting
+        assert(!holds(data));
+
+        jobs.push_back({&file, &data, frame});
+    }
+
+    // Wake the thread up
+    wake.notify_one();
+
+}
+
+// Function to wait until a container has been written (and can be used again)
+void Writer::wait(const std::vector<uint8_t> &data) {
+
+    // data: the container
+
+    // Wait until it is out of the queue
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [&] { return !holds(data); });
+
+}
+
+// Function to wait until every container has been written
+void Writer::drain() {
+
+    // Wait until the queue is empty
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [this] { return jobs.empty() && !current; });
+
+}
+
+// Function to count the containers not yet written
+size_t Writer::pending() {
+
+    std::lock_guard<std::mutex> lock(mutex);
+    return jobs.size() + (current != nullptr);
+
+}
+
+// Function to tell if a container is waiting or being written (lock held)
+bool Writer::holds(const std::vector<uint8_t> &data) const {
+
+    // data: the container
+
+    // Is it being written?
+    if (current == &data) return true;
+
+    // Or waiting?
+    return std::any_of(jobs.begin(), jobs.end(), [&](const Job &job) { return job.data == &data; });
+
+}
+
+// Function run by the background thread
+void Writer::work() {
+
+    // Until told to stop...
+    while (true) {
+
+        // Next container to write
+        Job job = {nullptr, nullptr, cdc::Frame()};
+
+        // Wait for one (or for the signal to stop once all are written)
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this] { return stop || !jobs.empty(); });
+            if (jobs.empty()) return;
+            job = jobs.front();
+            jobs.pop_front();
+            current = job.data;
+        }
+
+        // Write every byte to file, as a chunk if needed
+        if (job.frame.chunk) {
+            cdc::encode(chunk, *job.data, job.frame);
+            job.file->write((char *) chunk.data(), chunk.size());
+        }
+        else
+            job.file->write((char *) job.data->data(), job.data->size());
+
+        // Empty the container
+        job.data->clear();
+
+        // Report when done
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            current = nullptr;
+        }
+
+        // Let anyone waiting know
+        done.notify_all();
+
+    }
+}
@@ -0,0 +1,84 @@
+#ifndef RESCHOICE_WRITER_HPP
+#define RESCHOICE_WRITER_HPP
+
+// This is the header for the Writer class, a background thread that writes
+// containers of bytes to their output files while the simulation goes on.
+// Containers are handed over with write(), and are emptied once written. They
+// must not be touched until then, which wait() makes sure of. A buffer hands
+// over one container at a time (see Buffer), so the amount of data waiting to
+// be written is bounded and the simulation only has to wait when it fills a
+// container faster than the disk takes them. Containers are written in the
+// order they are handed over, so data end up in each file in the order they
+// were saved. Containers can be compressed (or framed) into chunks on the way
+// (see cdc), which is done by the background thread too.
+
+#include "codec.hpp"
+
+#include <vector>
+#include <deque>
+#include <fstream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <algorithm>
+#include <cstdint>
+#include <cassert>
+
+class Writer {
+
+public:
+
+    // Constructor
+    Writer();
+
+    // Destructor
+    ~Writer();
+
+    // No copies (threads cannot be copied)
+    Writer(const Writer&) = delete;
+    Writer& operator=(const Writer&) = delete;
+
+    // Setters
+    void write(std::ofstream&, std::vector<uint8_t>&, const cdc::Frame& = cdc::Frame());
+    void wait(const std::vector<uint8_t>&);
+    void drain();
+
+    // Getters
+    size_t pending();
+
+private:
+
+    // Container to write and where to
+    struct Job {
+
+        std::ofstream *file;          // output file stream
+        std::vector<uint8_t> *data;   // bytes to write
+        cdc::Frame frame;             // whether and how to frame them
+
+    };
+
+    // Synchronization
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+
+    // Containers waiting to be written, and the one being written
+    std::deque<Job> jobs;
+    const std::vector<uint8_t> *current;
+
+    // Whether to stop (once everything is written)
+    bool stop;
+
+    // Compressed chunk (only used by the background thread)
+    std::vector<uint8_t> chunk;
+
+    // Background thread (started last)
+    std::thread thread;
+
+    // Internal functions
+    void work();
+    bool holds(const std::vector<uint8_t>&) const;
+
+};
+
+#endif
@@ -5,6 +5,7 @@
 
 #include "testutils.hpp"
 #include "../src/buffer.hpp"
+#include "../src/random.hpp"
 #include <boost/test/unit_test.hpp>
 
 // Test that the buffer opens properly
@@ -155,4 +156,233 @@ BOOST_AUTO_TEST_CASE(bufferClosesWithEmptyFile) {
     // Remove files
     std::remove("output.dat");
 
-}
\ No newline at end of file
+}
+
+// Test that the buffer gives the same file when written in the background
+BOOST_AUTO_TEST_CASE(bufferWritesInBackground) {
+
+    // Create a background writer
+    Writer writer;
+
+    // Create a small buffer that uses it
+    Buffer buffer(3u, "output.dat", prt::f64, &writer);
+
+    // Open it
+    buffer.open();
+
+    // Store many more values than the capacity permits
+    for (size_t i = 0u; i < 1000u; ++i) buffer.save(static_cast<double>(i));
+
+    // Close the file (once everything is written)
+    buffer.close();
+
+    // Check
+    BOOST_CHECK(!buffer.isopen());
+    BOOST_CHECK_EQUAL(writer.pending(), 0u);
+
+    // Read the data back in
+    std::vector<double> values = tst::read("output.dat");
+
+    // Check that they are all there, in order
+    BOOST_REQUIRE_EQUAL(values.size(), 1000u);
+    for (size_t i = 0u; i < values.size(); ++i) BOOST_CHECK_EQUAL(values[i], static_cast<double>(i));
+
+    // Remove files
+    std::remove("output.dat");
+
+}
+
+// Test that values are written with the width of their type
+BOOST_AUTO_TEST_CASE(bufferWritesNarrowTypes) {
+
+    // Values to save (fitting in every type)
+    const std::vector<double> values = {0.0, 1.0, 1.0, 0.0, 1.0, 1.0, 1.0, 0.0, 0.0, 1.0, 1.0};
+
+    // For each type...
+    for (const prt::Type &type : {prt::bit, prt::u8, prt::u16, prt::u32, prt::f32, prt::f64}) {
+
+        // Create a small buffer (so it flushes along the way)
+        Buffer buffer(3u, "output.dat", type);
+
+        // Open it
+        buffer.open();
+
+        // Save the values
+        for (const double &x : values) buffer.save(x);
+
+        // Check the last one
+        BOOST_CHECK_EQUAL(buffer.last(), 1.0);
+
+        // Close the file
+        buffer.close();
+
+        // Check the size of the file
+        std::ifstream file("output.dat", std::ios::binary | std::ios::ate);
+        BOOST_CHECK_EQUAL(static_cast<size_t>(file.tellg()), (values.size() * prt::bits(type) + 7u) / 8u);
+        file.close();
+
+        // Read the data back in
+        const std::vector<double> saved = tst::read("output.dat", type);
+
+        // Check them (bits come with the padding of the last byte)
+        BOOST_REQUIRE_EQUAL(saved.size(), type == prt::bit ? 16u : values.size());
+        for (size_t i = 0u; i < saved.size(); ++i)
+            BOOST_CHECK_EQUAL(saved[i], i < values.size() ? values[i] : 0.0);
+
+        // Remove files
+        std::remove("output.dat");
+
+    }
+}
+
+// Test that integers and single precision numbers are written as such
+BOOST_AUTO_TEST_CASE(bufferWritesIntegersAndSingles) {
+
+    // Save a large count and a real number
+    Buffer counts(10u, "counts.dat", prt::u32);
+    Buffer reals(10u, "reals.dat", prt::f32);
+    counts.open();
+    reals.open();
+    counts.save(4000000000.0);
+    reals.save(0.1);
+
+    // Check the values kept
+    BOOST_CHECK_EQUAL(counts.last(), 4000000000.0);
+    BOOST_CHECK_EQUAL(reals.last(), static_cast<double>(0.1f));
+
+    // Close the files
+    counts.close();
+    reals.close();
+
+    // Read them back in
+    const std::vector<double> c = tst::read("counts.dat", prt::u32);
+    const std::vector<double> r = tst::read("reals.dat", prt::f32);
+
+    // Check
+    BOOST_REQUIRE_EQUAL(c.size(), 1u);
+    BOOST_REQUIRE_EQUAL(r.size(), 1u);
+    BOOST_CHECK_EQUAL(c[0u], 4000000000.0);
+    BOOST_CHECK_EQUAL(r[0u], static_cast<double>(0.1f));
+
+    // Remove files
+    std::remove("counts.dat");
+    std::remove("reals.dat");
+
+}
+
+// Test that compressed buffers give back the same values
+BOOST_AUTO_TEST_CASE(bufferWritesCompressedChunks) {
+
+    // Values to save (fitting in every type)
+    std::vector<double> values;
+    for (size_t i = 0u; i < 100u; ++i) values.push_back(static_cast<double>((i / 7u) % 2u));
+
+    // Create a background writer
+    Writer writer;
+
+    // For each type...
+    for (const prt::Type &type : {prt::bit, prt::u8, prt::u32, prt::f32, prt::f64}) {
+
+        // Write the values both compressed (in the background or not) and as they are
+        Buffer plain(10u, "plain.dat", type);
+        Buffer packed(10u, "packed.dat", type, nullptr, true);
+        Buffer background(10u, "background.dat", type, &writer, true);
+        plain.open();
+        packed.open();
+        background.open();
+        for (const double &x : values) {
+            plain.save(x);
+            packed.save(x);
+            background.save(x);
+        }
+        plain.close();
+        packed.close();
+        background.close();
+
+        // Check that the compressed files read back to the plain one
+        const std::vector<double> expected = tst::read("plain.dat", type);
+        BOOST_CHECK(tst::read("packed.dat", type, true) == expected);
+        BOOST_CHECK(tst::read("background.dat", type, true) == expected);
+
+        // Check that the compressed file is made of chunks
+        std::ifstream file("packed.dat", std::ios::binary);
+        std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        file.close();
+        BOOST_REQUIRE_GE(bytes.size(), cdc::header);
+        uint64_t count;
+        std::memcpy(&count, bytes.data() + 1u, 8u);
+        BOOST_CHECK_EQUAL(count, packed.capacity());
+
+        // Remove files
+        std::remove("plain.dat");
+        std::remove("packed.dat");
+        std::remove("background.dat");
+
+    }
+}
+
+// Test that quantized values are read back within the error bound
+BOOST_AUTO_TEST_CASE(bufferQuantizesWithinBound) {
+
+    // Values to save
+    std::vector<double> values;
+    for (size_t i = 0u; i < 1000u; ++i) values.push_back(rnd::normal(0.0, 1.0)(rnd::rng));
+
+    // For each error bound (the last one being too small for 32-bit integers)...
+    for (const double &bound : {1E-3, 1E-5, 1E-12}) {
+
+        // Save the values, compressed or not
+        Buffer plain(100u, "plain.dat", prt::f64, nullptr, false, bound);
+        Buffer packed(100u, "packed.dat", prt::f64, nullptr, true, bound);
+        plain.open();
+        packed.open();
+        for (const double &x : values) {
+            plain.save(x);
+            packed.save(x);
+        }
+        plain.close();
+        packed.close();
+
+        // Read them back
+        const std::vector<double> saved = tst::read("plain.dat", prt::f64, true);
+
+        // Check that they are within the bound
+        BOOST_REQUIRE_EQUAL(saved.size(), values.size());
+        for (size_t i = 0u; i < values.size(); ++i)
+            BOOST_CHECK_LE(std::abs(saved[i] - values[i]), bound);
+
+        // Check that compression does not change them
+        BOOST_CHECK(tst::read("packed.dat", prt::f64, true) == saved);
+
+        // Check the size of the file (levels take 16 bits, then 32, then the values stay doubles)
+        const size_t width = bound == 1E-3 ? 2u : bound == 1E-5 ? 4u : 8u;
+        std::ifstream file("plain.dat", std::ios::binary | std::ios::ate);
+        BOOST_CHECK_EQUAL(static_cast<size_t>(file.tellg()), 10u * cdc::header + values.size() * width);
+        file.close();
+
+        // Remove files
+        std::remove("plain.dat");
+        std::remove("packed.dat");
+
+    }
+}
+
+// Test that values that are not finite are not quantized
+BOOST_AUTO_TEST_CASE(bufferDoesNotQuantizeInfinity) {
+
+    // Values to save
+    const std::vector<double> values = {1.0, std::numeric_limits<double>::infinity(), 2.0};
+
+    // Save them
+    Buffer buffer(10u, "output.dat", prt::f64, nullptr, false, 0.1);
+    buffer.open();
+    for (const double &x : values) buffer.save(x);
+    buffer.close();
+
+    // Check that they are read back exactly
+    BOOST_CHECK(tst::read("output.dat", prt::f64, true) == values);
+
+    // Remove files
+    std::remove("output.dat");
+
+}
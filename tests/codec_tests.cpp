@@ -0,0 +1,220 @@
+#define BOOST_TEST_DYNAMIC_LINK
+#define BOOST_TEST_MODULE Main
+
+// Here we test the compression of output data.
+
+#include "testutils.hpp"
+#include "../src/codec.hpp"
+#include "../src/random.hpp"
+#include <boost/test/unit_test.hpp>
+
+// Function to get the bytes of some values
+template <typename T>
+std::vector<uint8_t> bytes(const std::vector<T> &values) {
+
+    // values: the values
+
+    std::vector<uint8_t> data(values.size() * sizeof(T));
+    std::memcpy(data.data(), values.data(), data.size());
+    return data;
+
+}
+
+// Function to describe how to compress some values
+cdc::Frame frame(const size_t &count, const size_t &width) {
+
+    // count: number of values
+    // width: width of a value (in bytes, zero for single bits)
+
+    cdc::Frame frame;
+    frame.chunk = true;
+    frame.compress = true;
+    frame.count = count;
+    frame.width = width;
+    return frame;
+
+}
+
+// Test that close values are compressed and read back exactly
+BOOST_AUTO_TEST_CASE(codecCompressesCloseValues) {
+
+    // Slowly changing values
+    std::vector<double> values;
+    for (size_t i = 0u; i < 1000u; ++i) values.push_back(1.0 + i * 0.25);
+
+    // Their bytes
+    const std::vector<uint8_t> data = bytes(values);
+
+    // Compress them
+    std::vector<uint8_t> chunk;
+    cdc::encode(chunk, data, frame(values.size(), sizeof(double)));
+
+    // Check that the chunk is smaller and uses the delta method
+    BOOST_CHECK_LT(chunk.size(), data.size());
+    BOOST_CHECK_EQUAL(chunk[18u], cdc::delta);
+
+    // Check that they are read back exactly
+    BOOST_CHECK(cdc::decode(chunk) == data);
+
+}
+
+// Test that values of every width are read back exactly
+BOOST_AUTO_TEST_CASE(codecRoundTripsAllWidths) {
+
+    // Random bytes with many repeats and runs of zeros
+    std::vector<uint8_t> data(210u);
+    for (size_t i = 0u; i < data.size(); ++i) data[i] = rnd::bernoulli(0.7)(rnd::rng) ? 0u : rnd::random(0u, 255u)(rnd::rng);
+
+    // For each width (zero for bits)...
+    for (size_t width : {0u, 1u, 2u, 3u, 5u, 7u}) {
+
+        // Number of values
+        const size_t count = width ? data.size() / width : data.size() * 8u - 3u;
+
+        // Only the bytes those values take
+        const std::vector<uint8_t> part(data.begin(), data.begin() + (width ? count * width : (count + 7u) / 8u));
+
+        // Compress them
+        std::vector<uint8_t> chunk;
+        cdc::encode(chunk, part, frame(count, width));
+
+        // Check the header
+        uint64_t n;
+        std::memcpy(&n, chunk.data() + 1u, 8u);
+        BOOST_CHECK_EQUAL(chunk[0u], cdc::version);
+        BOOST_CHECK_EQUAL(n, count);
+        BOOST_CHECK_EQUAL(chunk[17u], width);
+
+        // Check that they are read back exactly
+        BOOST_CHECK(cdc::decode(chunk) == part);
+
+    }
+}
+
+// Test that values that do not compress are stored as they are
+BOOST_AUTO_TEST_CASE(codecFallsBackToRaw) {
+
+    // Values with nothing in common
+    std::vector<uint8_t> data(100u);
+    for (size_t i = 0u; i < data.size(); ++i) data[i] = static_cast<uint8_t>(1u + 2u * i);
+
+    // Compress them
+    std::vector<uint8_t> chunk;
+    cdc::encode(chunk, data, frame(data.size(), 1u));
+
+    // Check that they are only framed
+    BOOST_CHECK_EQUAL(chunk.size(), cdc::header + data.size());
+    BOOST_CHECK_EQUAL(chunk[18u], cdc::raw);
+    BOOST_CHECK(std::equal(data.begin(), data.end(), chunk.begin() + cdc::header));
+
+    // Check that they are read back exactly
+    BOOST_CHECK(cdc::decode(chunk) == data);
+
+}
+
+// Test that chunks put end to end are read back in order
+BOOST_AUTO_TEST_CASE(codecReadsSuccessiveChunks) {
+
+    // Two containers of values
+    const std::vector<uint8_t> first = bytes(std::vector<uint32_t>{1u, 2u, 3u, 4u, 5u});
+    const std::vector<uint8_t> second = bytes(std::vector<uint32_t>{6u, 6u, 6u});
+
+    // Compress them one after the other
+    std::vector<uint8_t> chunk, stream;
+    cdc::encode(chunk, first, frame(5u, 4u));
+    stream.insert(stream.end(), chunk.begin(), chunk.end());
+    cdc::encode(chunk, second, frame(3u, 4u));
+    stream.insert(stream.end(), chunk.begin(), chunk.end());
+
+    // Expected values
+    std::vector<uint8_t> expected = first;
+    expected.insert(expected.end(), second.begin(), second.end());
+
+    // Check
+    BOOST_CHECK(cdc::decode(stream) == expected);
+
+}
+
+// Test that broken chunks are detected
+BOOST_AUTO_TEST_CASE(codecDetectsBrokenChunks) {
+
+    // Some values
+    const std::vector<uint8_t> data = bytes(std::vector<double>{1.0, 1.5, 2.0});
+
+    // Compress them
+    std::vector<uint8_t> chunk;
+    cdc::encode(chunk, data, frame(3u, 8u));
+
+    // Cut the header short
+    std::vector<uint8_t> broken(chunk.begin(), chunk.begin() + 10u);
+    tst::checkError([&] { cdc::decode(broken); }, "Truncated chunk header");
+
+    // Cut the payload short
+    broken.assign(chunk.begin(), chunk.end() - 1u);
+    tst::checkError([&] { cdc::decode(broken); }, "Truncated chunk");
+
+    // Use an unknown method
+    broken = chunk;
+    broken[18u] = 2u;
+    tst::checkError([&] { cdc::decode(broken); }, "Invalid compression method in chunk");
+
+    // Use an unknown version of the format
+    broken = chunk;
+    broken[0u] = cdc::version + 1u;
+    tst::checkError([&] { cdc::decode(broken); }, "Unsupported chunk version");
+
+}
+
+// Test that values can be stored as they are within a chunk
+BOOST_AUTO_TEST_CASE(codecFramesWithoutCompressing) {
+
+    // Values that would compress well
+    const std::vector<uint8_t> data(100u, 0u);
+
+    // Only frame them
+    cdc::Frame only = frame(data.size(), 1u);
+    only.compress = false;
+    std::vector<uint8_t> chunk;
+    cdc::encode(chunk, data, only);
+
+    // Check that they are stored as they are
+    BOOST_CHECK_EQUAL(chunk.size(), cdc::header + data.size());
+    BOOST_CHECK_EQUAL(chunk[18u], cdc::raw);
+    BOOST_CHECK(cdc::decode(chunk) == data);
+
+}
+
+// Test that quantized values are read back as doubles
+BOOST_AUTO_TEST_CASE(codecReadsQuantizedValues) {
+
+    // Levels as 16- and 32-bit integers
+    const std::vector<uint8_t> narrow = bytes(std::vector<uint16_t>{0u, 1u, 2u, 65535u});
+    const std::vector<uint8_t> wide = bytes(std::vector<uint32_t>{0u, 1u, 2u, 100000u});
+
+    // Expected values
+    const std::vector<uint8_t> expnarrow = bytes(std::vector<double>{-1.0, -0.5, 0.0, -1.0 + 0.5 * 65535.0});
+    const std::vector<uint8_t> expwide = bytes(std::vector<double>{-1.0, -0.5, 0.0, -1.0 + 0.5 * 100000.0});
+
+    // With and without compression...
+    for (const bool compress : {false, true}) {
+
+        // Frame both
+        cdc::Frame f16 = frame(4u, 2u), f32 = frame(4u, 4u);
+        f16.compress = f32.compress = compress;
+        f16.offset = f32.offset = -1.0;
+        f16.scale = f32.scale = 0.5;
+        std::vector<uint8_t> chunk, stream;
+        cdc::encode(chunk, narrow, f16);
+        stream.insert(stream.end(), chunk.begin(), chunk.end());
+        cdc::encode(chunk, wide, f32);
+        stream.insert(stream.end(), chunk.begin(), chunk.end());
+
+        // Expected values, end to end
+        std::vector<uint8_t> expected = expnarrow;
+        expected.insert(expected.end(), expwide.begin(), expwide.end());
+
+        // Check
+        BOOST_CHECK(cdc::decode(stream) == expected);
+
+    }
+}
@@ -0,0 +1,73 @@
+#define BOOST_TEST_DYNAMIC_LINK
+#define BOOST_TEST_MODULE Main
+
+// Here we test the storage of individuals as classes of identical ones.
+
+#include "../src/cohorts.hpp"
+#include <boost/test/unit_test.hpp>
+
+// Test that classes develop like individuals
+BOOST_AUTO_TEST_CASE(cohortsDevelopLikeIndividuals) {
+
+    // Create classes
+    Cohorts cohorts(2.0);
+    cohorts.add(0.5, true, 10u, 1.0);
+
+    // And an individual
+    Individual ind(0.5, 1.0);
+
+    // Check
+    BOOST_CHECK_EQUAL(cohorts.size(), 1u);
+    BOOST_CHECK_EQUAL(cohorts.total(), 10u);
+    BOOST_CHECK_EQUAL(static_cast<utl::Real>(cohorts[0u].eff1), ind.getEff1());
+    BOOST_CHECK_EQUAL(static_cast<utl::Real>(cohorts[0u].eff2), ind.getEff2());
+    BOOST_CHECK_CLOSE(cohorts[0u].miss1, exp(-2.0 * cohorts[0u].eff1), 1e-12);
+    BOOST_CHECK_CLOSE(cohorts[0u].miss2, exp(-2.0 * cohorts[0u].eff2), 1e-12);
+    BOOST_CHECK(cohorts[0u].habitat);
+
+}
+
+// Test that identical classes are pooled and empty ones dropped
+BOOST_AUTO_TEST_CASE(cohortsMerge) {
+
+    // Create classes
+    Cohorts cohorts;
+    cohorts.add(1.0, true, 2u, 1.0);
+    cohorts.add(0.0, false, 3u, 1.0);
+    cohorts.add(1.0, false, 0u, 1.0);
+    cohorts.add(1.0, true, 4u, 1.0);
+    cohorts.clone(cohorts[1u], true, 5u);
+
+    // Check
+    BOOST_CHECK_EQUAL(cohorts.size(), 5u);
+    BOOST_CHECK_EQUAL(cohorts[4u].x, 0.0);
+    BOOST_CHECK_EQUAL(cohorts[4u].count, 5u);
+
+    // Merge
+    cohorts.merge();
+
+    // Check that they are sorted by habitat and trait value
+    BOOST_REQUIRE_EQUAL(cohorts.size(), 3u);
+    BOOST_CHECK_EQUAL(cohorts.total(), 14u);
+    BOOST_CHECK(!cohorts[0u].habitat);
+    BOOST_CHECK_EQUAL(cohorts[0u].x, 0.0);
+    BOOST_CHECK_EQUAL(cohorts[0u].count, 3u);
+    BOOST_CHECK(cohorts[1u].habitat);
+    BOOST_CHECK_EQUAL(cohorts[1u].x, 0.0);
+    BOOST_CHECK_EQUAL(cohorts[1u].count, 5u);
+    BOOST_CHECK(cohorts[2u].habitat);
+    BOOST_CHECK_EQUAL(cohorts[2u].x, 1.0);
+    BOOST_CHECK_EQUAL(cohorts[2u].count, 6u);
+
+    // Check the first class of the second habitat
+    BOOST_CHECK_EQUAL(cohorts.split(), 1u);
+
+    // Check that individuals are found in the right classes
+    BOOST_CHECK_EQUAL(cohorts.find(0u), 0u);
+    BOOST_CHECK_EQUAL(cohorts.find(2u), 0u);
+    BOOST_CHECK_EQUAL(cohorts.find(3u), 1u);
+    BOOST_CHECK_EQUAL(cohorts.find(7u), 1u);
+    BOOST_CHECK_EQUAL(cohorts.find(8u), 2u);
+    BOOST_CHECK_EQUAL(cohorts.find(13u), 2u);
+
+}
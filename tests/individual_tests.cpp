@@ -85,9 +85,9 @@ BOOST_AUTO_TEST_CASE(mutation) {
 
     Individual ind(0.0, 0.0);
     ind.mutate(0.01, 1.0);
-    BOOST_CHECK_EQUAL(ind.getX(), 0.01);
+    BOOST_CHECK_EQUAL(ind.getX(), static_cast<utl::Real>(0.01));
     ind.mutate(-0.02, 1.0);
-    BOOST_CHECK_EQUAL(ind.getX(), -0.01);
+    BOOST_CHECK_EQUAL(ind.getX(), static_cast<utl::Real>(-0.01));
 
 }
 
@@ -110,3 +110,40 @@ BOOST_AUTO_TEST_CASE(rankAssignment) {
     BOOST_CHECK_EQUAL(ind.getRank(), 30u);
 
 }
+
+// Test the probabilities of choosing the second resource
+BOOST_AUTO_TEST_CASE(choiceThresholds) {
+
+    // Perfect choice
+    const ind::Thresholds probs1 = ind::thresholds(0.0, 1.0, 1.0, 1.0);
+    BOOST_CHECK_EQUAL(probs1[0u], 0.0);
+    BOOST_CHECK_EQUAL(probs1[1u], 1.0);
+    BOOST_CHECK_EQUAL(probs1[2u], 0.5);
+
+    // Random choice weighted by resource abundance
+    const ind::Thresholds probs2 = ind::thresholds(1.0, 0.0, 1.0, 3.0);
+    BOOST_CHECK_EQUAL(probs2[0u], 0.75);
+    BOOST_CHECK_EQUAL(probs2[1u], 0.75);
+    BOOST_CHECK_EQUAL(probs2[2u], 0.75);
+
+}
+
+// Test that a single draw decides the choice
+BOOST_AUTO_TEST_CASE(choiceFromSingleDraw) {
+
+    // Thresholds
+    const ind::Thresholds probs = {0.2, 0.7, 0.45};
+
+    // When resource 1 is better
+    BOOST_CHECK(ind::choose(1.0, 0.0, probs, 0.1));
+    BOOST_CHECK(!ind::choose(1.0, 0.0, probs, 0.3));
+
+    // When resource 2 is better
+    BOOST_CHECK(ind::choose(0.0, 1.0, probs, 0.6));
+    BOOST_CHECK(!ind::choose(0.0, 1.0, probs, 0.8));
+
+    // When both are equal
+    BOOST_CHECK(ind::choose(1.0, 1.0, probs, 0.4));
+    BOOST_CHECK(!ind::choose(1.0, 1.0, probs, 0.5));
+
+}
@@ -47,6 +47,14 @@ BOOST_AUTO_TEST_CASE(readParameters)
     content << "verbose 1\n";
     content << "choose 0\n";
     content << "memsave 1.0\n";
+    content << "multinomial 1\n";
+    content << "nthreads 4\n";
+    content << "renormalize 1000\n";
+    content << "cohorts 1\n";
+    content << "prefetch 16\n";
+    content << "blocksize 64\n";
+    content << "speculate 1\n";
+    content << "compress 1\n";
 
     // Write the content to a file
     tst::write("parameters.txt", content.str());
@@ -74,6 +82,14 @@ BOOST_AUTO_TEST_CASE(readParameters)
     BOOST_CHECK(pars.verbose);
     BOOST_CHECK(!pars.choose);
     BOOST_CHECK_EQUAL(pars.memsave, 1.0);
+    BOOST_CHECK(pars.multinomial);
+    BOOST_CHECK_EQUAL(pars.nthreads, 4u);
+    BOOST_CHECK_EQUAL(pars.renormalize, 1000u);
+    BOOST_CHECK(pars.cohorts);
+    BOOST_CHECK_EQUAL(pars.prefetch, 16u);
+    BOOST_CHECK_EQUAL(pars.blocksize, 64u);
+    BOOST_CHECK(pars.speculate);
+    BOOST_CHECK(pars.compress);
 
     // Remove files
     std::remove("parameters.txt");
@@ -439,6 +455,132 @@ BOOST_AUTO_TEST_CASE(readInvalidVerbose)
     
 }
 
+// Test that error upon invalid multinomial reproduction flag
+BOOST_AUTO_TEST_CASE(readInvalidMultinomial)
+{
+
+    // Write a file with invalid multinomial reproduction flag
+    tst::write("p1.txt", "multinomial 1 1");
+    
+    // Check
+    tst::checkError([&]() { Parameters pars("p1.txt"); }, "Too many values for parameter multinomial in line 1 of file p1.txt");
+    
+    // Remove files
+    std::remove("p1.txt");
+    
+}
+
+// Test error upon invalid number of threads
+BOOST_AUTO_TEST_CASE(readInvalidNThreads)
+{
+
+    // Write a file with invalid number of threads
+    tst::write("p1.txt", "nthreads 0\n");
+    tst::write("p2.txt", "nthreads 2 2\n");
+
+    // Check
+    tst::checkError([&]() { Parameters pars("p1.txt"); }, "Parameter nthreads must be strictly positive in line 1 of file p1.txt");
+    tst::checkError([&]() { Parameters pars("p2.txt"); }, "Too many values for parameter nthreads in line 1 of file p2.txt");
+
+    // Remove files
+    std::remove("p1.txt");
+    std::remove("p2.txt");
+
+}
+
+// Test error upon invalid renormalization interval
+BOOST_AUTO_TEST_CASE(readInvalidRenormalize)
+{
+
+    // Write a file with invalid renormalization interval
+    tst::write("p1.txt", "renormalize 10 10\n");
+
+    // Check
+    tst::checkError([&]() { Parameters pars("p1.txt"); }, "Too many values for parameter renormalize in line 1 of file p1.txt");
+
+    // Remove files
+    std::remove("p1.txt");
+
+}
+
+// Test error upon invalid cohort flag
+BOOST_AUTO_TEST_CASE(readInvalidCohorts)
+{
+
+    // Write a file with invalid cohort flag
+    tst::write("p1.txt", "cohorts 1 1\n");
+
+    // Check
+    tst::checkError([&]() { Parameters pars("p1.txt"); }, "Too many values for parameter cohorts in line 1 of file p1.txt");
+
+    // Remove files
+    std::remove("p1.txt");
+
+}
+
+// Test error upon invalid prefetching distance
+BOOST_AUTO_TEST_CASE(readInvalidPrefetch)
+{
+
+    // Write a file with invalid prefetching distance
+    tst::write("p1.txt", "prefetch 16 16\n");
+
+    // Check
+    tst::checkError([&]() { Parameters pars("p1.txt"); }, "Too many values for parameter prefetch in line 1 of file p1.txt");
+
+    // Remove files
+    std::remove("p1.txt");
+
+}
+
+// Test error upon invalid block size
+BOOST_AUTO_TEST_CASE(readInvalidBlockSize)
+{
+
+    // Write a file with invalid block size
+    tst::write("p1.txt", "blocksize 0\n");
+    tst::write("p2.txt", "blocksize 2 2\n");
+
+    // Check
+    tst::checkError([&]() { Parameters pars("p1.txt"); }, "Parameter blocksize must be strictly positive in line 1 of file p1.txt");
+    tst::checkError([&]() { Parameters pars("p2.txt"); }, "Too many values for parameter blocksize in line 1 of file p2.txt");
+
+    // Remove files
+    std::remove("p1.txt");
+    std::remove("p2.txt");
+
+}
+
+// Test error upon invalid speculation flag
+BOOST_AUTO_TEST_CASE(readInvalidSpeculate)
+{
+
+    // Write a file with invalid speculation flag
+    tst::write("p1.txt", "speculate 1 1\n");
+
+    // Check
+    tst::checkError([&]() { Parameters pars("p1.txt"); }, "Too many values for parameter speculate in line 1 of file p1.txt");
+
+    // Remove files
+    std::remove("p1.txt");
+
+}
+
+// Test error upon invalid compression flag
+BOOST_AUTO_TEST_CASE(readInvalidCompress)
+{
+
+    // Write a file with invalid compression flag
+    tst::write("p1.txt", "compress 1 1\n");
+
+    // Check
+    tst::checkError([&]() { Parameters pars("p1.txt"); }, "Too many values for parameter compress in line 1 of file p1.txt");
+
+    // Remove files
+    std::remove("p1.txt");
+
+}
+
 // Test that the parameter saving function works
 BOOST_AUTO_TEST_CASE(parameterSavingWorks) {
 
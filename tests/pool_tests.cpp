@@ -0,0 +1,50 @@
+#define BOOST_TEST_DYNAMIC_LINK
+#define BOOST_TEST_MODULE Main
+
+// Here we test the pool of threads.
+
+#include "../src/pool.hpp"
+#include <boost/test/unit_test.hpp>
+
+// Test that a single-threaded pool runs tasks in order
+BOOST_AUTO_TEST_CASE(poolRunsTasksInOrder) {
+
+    // Create a pool
+    Pool pool;
+
+    // Check
+    BOOST_CHECK_EQUAL(pool.size(), 1u);
+
+    // Record the order of the tasks
+    std::vector<size_t> order;
+    pool.run(5u, [&](const size_t &i) { order.push_back(i); });
+
+    // Check
+    BOOST_CHECK_EQUAL(order.size(), 5u);
+    for (size_t i = 0u; i < order.size(); ++i)
+        BOOST_CHECK_EQUAL(order[i], i);
+
+}
+
+// Test that a multi-threaded pool runs every task once
+BOOST_AUTO_TEST_CASE(poolRunsEveryTaskOnce) {
+
+    // Create a pool
+    Pool pool(4u);
+
+    // Check
+    BOOST_CHECK_EQUAL(pool.size(), 4u);
+
+    // Run several batches of tasks
+    for (size_t b = 0u; b < 10u; ++b) {
+
+        // Count how many times each task is run
+        std::vector<size_t> counts(100u, 0u);
+        pool.run(counts.size(), [&](const size_t &i) { ++counts[i]; });
+
+        // Check
+        for (size_t i = 0u; i < counts.size(); ++i)
+            BOOST_CHECK_EQUAL(counts[i], 1u);
+
+    }
+}
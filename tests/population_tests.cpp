@@ -6,6 +6,24 @@
 #include "testutils.hpp"
 #include "../src/population.hpp"
 #include <boost/test/unit_test.hpp>
+#include <cstdlib>
+#include <algorithm>
+#include <new>
+
+// Count heap allocations made by the program (see test below)
+static size_t nallocs = 0u;
+
+// Replace global allocation functions to keep track of allocations
+void* operator new(std::size_t size) {
+
+    ++nallocs;
+    if (void *ptr = std::malloc(size ? size : 1u)) return ptr;
+    throw std::bad_alloc();
+
+}
+
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+void operator delete(void *ptr, std::size_t) noexcept { std::free(ptr); }
 
 // Test that a population initializes properly
 BOOST_AUTO_TEST_CASE(populationInitializesProperly) {
@@ -173,20 +191,119 @@ BOOST_AUTO_TEST_CASE(fitnessCalculation) {
 
 }
 
+// Test that the realized fitness kernel agrees with the fitness function
+BOOST_AUTO_TEST_CASE(rewardMatchesFitness) {
+
+    // With feeding efficiencies above zero, and then all zero
+    for (const double tradeoff : {1.0, 1000.0}) {
+
+        // Create individuals
+        Storage storage;
+        for (size_t i = 0u; i < 37u; ++i) {
+            storage.add(Individual(tradeoff < 10.0 ? 0.1 * i - 1.8 : 0.0, tradeoff));
+            storage.setChoice(i, i % 3u == 0u);
+        }
+
+        // Outcome of the feeding round
+        pop::Gains gain;
+        gain.discovered = {0.7, 0.4};
+        for (size_t i = 0u; i < storage.size(); ++i) {
+            const bool choice = storage.getChoice(i);
+            gain.sumeffs[choice] += choice ? storage.getEff2(i) : storage.getEff1(i);
+            ++gain.n[choice];
+        }
+
+        // Fitnesses so far
+        std::vector<utl::Real> fitnesses(storage.size(), 1.0);
+
+        // Add the realized fitness of some of the individuals
+        pop::reward(storage, 2u, 35u, gain, fitnesses);
+
+        // Check that the same values are obtained as with the fitness function
+        for (size_t i = 0u; i < storage.size(); ++i) {
+
+            // Expected value
+            const bool choice = storage.getChoice(i);
+            const double eff = choice ? storage.getEff2(i) : storage.getEff1(i);
+            const double fit = pop::fitness(gain.discovered[choice], eff, gain.sumeffs[choice], gain.n[choice]);
+
+            // Check (only those in range should have changed)
+            BOOST_CHECK_EQUAL(fitnesses[i], static_cast<utl::Real>(i >= 2u && i < 35u ? 1.0 + fit : 1.0));
+
+        }
+    }
+}
+
+// Test that the statistics kernel adds up the right statistics
+BOOST_AUTO_TEST_CASE(accumulateSumsStatistics) {
+
+    // Create individuals in the second habitat, of either ecotype
+    Storage storage;
+    for (size_t i = 0u; i < 21u; ++i) {
+        Individual ind(0.1 * i - 1.0, 1.0);
+        ind.disperse();
+        storage.add(ind);
+        storage.setEcotype(i, 0.05);
+    }
+
+    // Add up the statistics of some of them
+    stat::Sums sums;
+    stat::accumulate(sums, storage, 3u, 21u, true);
+
+    // Compute them one by one
+    stat::Sums check;
+    for (size_t i = 3u; i < 21u; ++i) {
+        const double x = storage.getX(i);
+        const bool ecotype = storage.getEcotype(i);
+        ++check.n[1u][ecotype];
+        check.sumx[1u][ecotype] += x;
+        check.ssqx[1u][ecotype] += x * x;
+    }
+
+    // Check
+    for (size_t h = 0u; h < 2u; ++h) {
+        for (size_t e = 0u; e < 2u; ++e) {
+            BOOST_CHECK_EQUAL(sums.n[h][e], check.n[h][e]);
+            BOOST_CHECK_CLOSE(sums.sumx[h][e], check.sumx[h][e], 1e-10);
+            BOOST_CHECK_CLOSE(sums.ssqx[h][e], check.ssqx[h][e], 1e-10);
+        }
+    }
+
+    // Check that both ecotypes were there
+    BOOST_CHECK(sums.n[1u][0u] > 0u);
+    BOOST_CHECK(sums.n[1u][1u] > 0u);
+
+}
+
+// Test that the right feeding kernel is picked for the parameters
+BOOST_AUTO_TEST_CASE(feedingRegimes) {
+
+    BOOST_CHECK_EQUAL(pop::classify(0.5, 0.5, 0.5), pop::generic);
+    BOOST_CHECK_EQUAL(pop::classify(0.5, 1.0, 0.5), pop::accurate);
+    BOOST_CHECK_EQUAL(pop::classify(0.0, 0.0, 0.5), pop::coinflip);
+    BOOST_CHECK_EQUAL(pop::classify(0.5, 0.0, 0.5), pop::generic);
+    BOOST_CHECK_EQUAL(pop::classify(0.5, 0.5, 0.0), pop::onesided);
+
+    // The regime that saves the most work wins
+    BOOST_CHECK_EQUAL(pop::classify(0.0, 0.0, 0.0), pop::coinflip);
+    BOOST_CHECK_EQUAL(pop::classify(0.5, 1.0, 0.0), pop::accurate);
+
+}
+
 // Ecological isolation is correctly calculated
 BOOST_AUTO_TEST_CASE(ecologicalIsolation) {
 
-    BOOST_CHECK_EQUAL(stat::ei({{2u, 2u}, {0u, 0u}}, {{-2.0, 2.0}, {0.0, 0.0}}, {{2.0, 2.0}, {0.0, 0.0}}), 1.0);
-    BOOST_CHECK_EQUAL(stat::ei({{2u, 0u}, {0u, 0u}}, {{-2.0, 0.0}, {0.0, 0.0}}, {{2.0, 0.0}, {0.0, 0.0}}), 0.0);
+    BOOST_CHECK_EQUAL(stat::ei({{{2u, 2u}, {0u, 0u}}}, {{{-2.0, 2.0}, {0.0, 0.0}}}, {{{2.0, 2.0}, {0.0, 0.0}}}), 1.0);
+    BOOST_CHECK_EQUAL(stat::ei({{{2u, 0u}, {0u, 0u}}}, {{{-2.0, 0.0}, {0.0, 0.0}}}, {{{2.0, 0.0}, {0.0, 0.0}}}), 0.0);
 
 }
 
 // Spatial isolation is correctly calculated
 BOOST_AUTO_TEST_CASE(spatialIsolation) {
 
-    BOOST_CHECK_EQUAL(stat::si({{1u, 0u}, {0u, 1u}}), 1.0);
-    BOOST_CHECK_EQUAL(stat::si({{1u, 1u}, {1u, 1u}}), 0.0);
-    BOOST_CHECK_EQUAL(stat::si({{1u, 1u}, {0u, 0u}}), 0.0);
+    BOOST_CHECK_EQUAL(stat::si({{{1u, 0u}, {0u, 1u}}}), 1.0);
+    BOOST_CHECK_EQUAL(stat::si({{{1u, 1u}, {1u, 1u}}}), 0.0);
+    BOOST_CHECK_EQUAL(stat::si({{{1u, 1u}, {0u, 0u}}}), 0.0);
 
 }
 
@@ -269,4 +386,686 @@ BOOST_AUTO_TEST_CASE(populationCycleWithMutation) {
     // Check that the mean trait value has changed
     BOOST_CHECK(pop.getX(0u) != pars.xstart);
 
-}
\ No newline at end of file
+}
+
+// The life cycle does not allocate memory once the population is set up
+BOOST_AUTO_TEST_CASE(populationCycleDoesNotAllocate) {
+
+    // Parameters
+    Parameters pars;
+
+    // Tweak
+    pars.popsize = 100u;
+    pars.mutrate = 0.5;
+    pars.dispersal = 0.5;
+
+    // Create a population
+    Population pop(pars);
+
+    // Printer
+    Printer print({"foo", "bar"});
+
+    // Run a first cycle
+    pop.cycle(print);
+
+    // Reset the counter
+    nallocs = 0u;
+
+    // Run a few more cycles
+    for (size_t t = 0u; t < 5u; ++t) pop.cycle(print);
+
+    // Check that no allocation happened
+    BOOST_CHECK_EQUAL(nallocs, 0u);
+
+}
+
+// Population cycle with multinomial reproduction
+BOOST_AUTO_TEST_CASE(populationCycleWithMultinomialReproduction) {
+
+    // Parameters
+    Parameters pars;
+
+    // Tweak
+    pars.multinomial = true;
+    pars.dispersal = 1.0;
+    pars.popsize = 100u;
+
+    // Create a population
+    Population pop(pars);
+
+    // Printer
+    Printer print({"foo", "bar"});
+
+    // Cycle
+    pop.cycle(print);
+
+    // Check that the population size has not changed
+    BOOST_CHECK_EQUAL(pop.size(), pars.popsize);
+
+    // Check that every offspring has dispersed
+    for (size_t i = 0u; i < pop.size(); ++i)
+        BOOST_CHECK_EQUAL(pop.getHabitat(i), 1u);
+
+}
+
+// Multinomial reproduction works even when nobody has any fitness
+BOOST_AUTO_TEST_CASE(populationCycleWithMultinomialReproductionAndNoFitness) {
+
+    // Parameters
+    Parameters pars;
+
+    // Tweak (no resource is ever discovered)
+    pars.multinomial = true;
+    pars.delta = 0.0;
+    pars.popsize = 100u;
+
+    // Create a population
+    Population pop(pars);
+
+    // Printer
+    Printer print({"foo", "bar"});
+
+    // Cycle
+    pop.cycle(print);
+
+    // Check that the population size has not changed
+    BOOST_CHECK_EQUAL(pop.size(), pars.popsize);
+
+}
+
+// The outcome of a simulation does not depend on the number of threads
+BOOST_AUTO_TEST_CASE(populationCycleIndependentOfThreads) {
+
+    // Parameters
+    Parameters pars;
+
+    // Tweak (several chunks of offspring)
+    pars.popsize = 3u * pop::grain + 10u;
+    pars.nrounds = 2u;
+    pars.mutrate = 0.1;
+    pars.mutsdev = 0.1;
+    pars.dispersal = 0.1;
+    pars.seed = 42u;
+
+    // Printer
+    Printer print({"foo", "bar"});
+
+    // Run with one thread
+    rnd::rng.seed(pars.seed);
+    Population pop1(pars);
+    for (size_t t = 0u; t < 3u; ++t, pop1.moveon()) pop1.cycle(print);
+
+    // And with several
+    pars.nthreads = 4u;
+    rnd::rng.seed(pars.seed);
+    Population pop2(pars);
+    for (size_t t = 0u; t < 3u; ++t, pop2.moveon()) pop2.cycle(print);
+
+    // Check that the populations are the same
+    for (size_t i = 0u; i < pars.popsize; ++i) {
+        BOOST_REQUIRE_EQUAL(pop1.getX(i), pop2.getX(i));
+        BOOST_REQUIRE_EQUAL(pop1.getHabitat(i), pop2.getHabitat(i));
+    }
+}
+
+// Test that feeding both habitats at the same time gives the same outputs
+BOOST_AUTO_TEST_CASE(populationFeedingIndependentOfThreads) {
+
+    // Parameters
+    Parameters pars;
+
+    // Tweak (individuals in both habitats)
+    pars.popsize = 1000u;
+    pars.nrounds = 3u;
+    pars.hsymmetry = 0.5;
+    pars.dispersal = 0.5;
+    pars.tsave = 1u;
+
+    // Outputs to compare
+    const std::vector<std::string> names = {"individualRank", "individualChoice", "individualExpectedFitnessDifference", "resourceCensus"};
+
+    // Run with one and two threads
+    std::vector<std::vector<double> > outputs[2u];
+    for (size_t k = 0u; k < 2u; ++k) {
+
+        // Number of threads
+        pars.nthreads = k + 1u;
+
+        // Population
+        rnd::rng.seed(42u);
+        Population pop(pars);
+
+        // Printer
+        Printer print(names);
+        print.open();
+
+        // A few generations (the first one puts individuals in both habitats)
+        for (size_t t = 0u; t < 3u; ++t, pop.moveon()) pop.cycle(print);
+        print.close();
+
+        // Read values back in and remove files
+        for (const std::string &name : names) {
+            outputs[k].push_back(tst::read(name + ".dat"));
+            std::remove((name + ".dat").c_str());
+        }
+    }
+
+    // Check that every individual got a distinct rank in every round
+    std::vector<double> ranks = outputs[0u][0u];
+    BOOST_REQUIRE_EQUAL(ranks.size(), 3u * pars.nrounds * pars.popsize);
+    std::sort(ranks.begin(), ranks.end());
+    for (size_t i = 0u; i < ranks.size(); ++i)
+        BOOST_REQUIRE_EQUAL(ranks[i], static_cast<double>(i / (3u * pars.nrounds)));
+
+    // Check that both habitats were fed in the last generation
+    const std::vector<double> &census = outputs[0u][3u];
+    const size_t m = census.size();
+    BOOST_REQUIRE_EQUAL(m, 3u * pars.nrounds * 4u);
+    BOOST_CHECK(census[m - 4u] + census[m - 3u] > 0.0);
+    BOOST_CHECK(census[m - 2u] + census[m - 1u] > 0.0);
+
+    // Check that the outputs are the same
+    for (size_t j = 0u; j < names.size(); ++j) {
+        BOOST_REQUIRE_EQUAL(outputs[0u][j].size(), outputs[1u][j].size());
+        for (size_t i = 0u; i < outputs[0u][j].size(); ++i)
+            BOOST_REQUIRE_EQUAL(outputs[0u][j][i], outputs[1u][j][i]);
+    }
+}
+
+// Test that nothing is recorded in generations that are not saved
+BOOST_AUTO_TEST_CASE(populationOnlyPrintsWhenItIsTime) {
+
+    // Parameters
+    Parameters pars;
+
+    // Tweak
+    pars.popsize = 3u;
+    pars.tsave = 2u;
+
+    // Population
+    Population pop(pars);
+
+    // Printer
+    Printer print({"time", "individualRank", "traitMean"});
+
+    // Open the printer
+    print.open();
+
+    // A few generations
+    for (size_t t = 0u; t < 3u; ++t, pop.moveon()) pop.cycle(print);
+
+    // Close the printer
+    print.close();
+
+    // Read values back in
+    std::vector<double> time = tst::read("time.dat");
+    std::vector<double> individualRank = tst::read("individualRank.dat");
+    std::vector<double> traitMean = tst::read("traitMean.dat");
+
+    // Check that only generations 0 and 2 were recorded
+    BOOST_REQUIRE_EQUAL(time.size(), 2u);
+    BOOST_CHECK_EQUAL(time[0u], 0.0);
+    BOOST_CHECK_EQUAL(time[1u], 2.0);
+    BOOST_CHECK_EQUAL(individualRank.size(), 2u * pars.nrounds * pars.popsize);
+    BOOST_CHECK_EQUAL(traitMean.size(), 2u);
+
+    // Remove files
+    std::remove("time.dat");
+    std::remove("individualRank.dat");
+    std::remove("traitMean.dat");
+
+}
+
+// Test that choices follow expected fitnesses in the regimes with their own kernels
+BOOST_AUTO_TEST_CASE(populationFeedingInSpecialRegimes) {
+
+    // Parameters
+    Parameters pars;
+
+    // Tweak (variation in trait values, individuals in both habitats)
+    pars.popsize = 1000u;
+    pars.nrounds = 2u;
+    pars.hsymmetry = 0.5;
+    pars.dispersal = 0.5;
+    pars.mutrate = 1.0;
+    pars.mutsdev = 0.5;
+    pars.tsave = 1u;
+
+    // Outputs to check
+    const std::vector<std::string> names = {"individualChoice", "individualExpectedFitnessDifference", "individualHabitat"};
+
+    // Function to run a few generations and read back the last one
+    auto run = [&](std::vector<double> &choices, std::vector<double> &diffs, std::vector<double> &habitats) {
+
+        // Population
+        rnd::rng.seed(42u);
+        Population pop(pars);
+
+        // Printer
+        Printer print(names);
+        print.open();
+        for (size_t t = 0u; t < 3u; ++t, pop.moveon()) pop.cycle(print);
+        print.close();
+
+        // Read values back in and remove files
+        choices = tst::read("individualChoice.dat");
+        diffs = tst::read("individualExpectedFitnessDifference.dat");
+        habitats = tst::read("individualHabitat.dat");
+        for (const std::string &name : names) std::remove((name + ".dat").c_str());
+
+        // Check
+        BOOST_REQUIRE_EQUAL(choices.size(), 3u * pars.nrounds * pars.popsize);
+        BOOST_REQUIRE_EQUAL(diffs.size(), choices.size());
+        BOOST_REQUIRE_EQUAL(habitats.size(), 3u * pars.popsize);
+
+    };
+
+    // Containers
+    std::vector<double> choices, diffs, habitats;
+
+    // Perfectly accurate choice: the best resource is always chosen
+    pars.beta = 1.0;
+    run(choices, diffs, habitats);
+    for (size_t i = 0u; i < choices.size(); ++i)
+        if (diffs[i] != 0.0) BOOST_REQUIRE_EQUAL(choices[i], static_cast<double>(diffs[i] > 0.0));
+
+    // Random choice: about half choose each resource, whatever the expected fitnesses (PROBABILISTIC)
+    pars.beta = 0.0;
+    pars.alpha = 0.0;
+    run(choices, diffs, habitats);
+    const double sum = std::accumulate(choices.begin(), choices.end(), 0.0);
+    BOOST_CHECK_CLOSE(sum / choices.size(), 0.5, 5.0);
+    BOOST_CHECK(std::any_of(diffs.begin(), diffs.end(), [](const double &d) { return d != 0.0; }));
+
+    // One resource per habitat: nothing is expected from the absent one
+    pars.beta = 0.5;
+    pars.hsymmetry = 0.0;
+    run(choices, diffs, habitats);
+    for (size_t i = 0u; i < diffs.size(); ++i) {
+
+        // Habitat of the individual (recorded once per generation)
+        const size_t t = i / (pars.nrounds * pars.popsize);
+        const bool habitat = habitats[t * pars.popsize + i % pars.popsize];
+
+        // Resource 1 is only found in habitat 0 and resource 2 in habitat 1
+        if (habitat) BOOST_REQUIRE(diffs[i] >= 0.0); else BOOST_REQUIRE(diffs[i] <= 0.0);
+
+    }
+
+}
+
+// Test that a population of classes keeps its size and only has as many classes as needed
+BOOST_AUTO_TEST_CASE(populationCycleWithCohorts) {
+
+    // Parameters
+    Parameters pars;
+
+    // Tweak (no mutation)
+    pars.popsize = 1000u;
+    pars.dispersal = 0.1;
+    pars.mutrate = 0.0;
+    pars.cohorts = true;
+
+    // Population
+    Population pop(pars);
+
+    // Printer
+    Printer print({"foo", "bar"});
+
+    // Check
+    BOOST_CHECK_EQUAL(pop.size(), pars.popsize);
+    BOOST_CHECK_EQUAL(pop.getNClasses(), 1u);
+
+    // A few generations
+    for (size_t t = 0u; t < 5u; ++t, pop.moveon()) pop.cycle(print);
+
+    // Check that there is one class per habitat
+    BOOST_CHECK_EQUAL(pop.size(), pars.popsize);
+    BOOST_CHECK_EQUAL(pop.getNClasses(), 2u);
+
+    // With the same trait value
+    BOOST_CHECK_EQUAL(pop.getX(0u), pars.xstart);
+    BOOST_CHECK_EQUAL(pop.getX(pars.popsize - 1u), pars.xstart);
+    BOOST_CHECK(!pop.getHabitat(0u));
+    BOOST_CHECK(pop.getHabitat(pars.popsize - 1u));
+
+    // Now with mutations
+    pars.mutrate = 0.1;
+    pars.mutsdev = 0.1;
+    Population pop2(pars);
+    for (size_t t = 0u; t < 5u; ++t, pop2.moveon()) pop2.cycle(print);
+
+    // Check that there is more variation
+    BOOST_CHECK_EQUAL(pop2.size(), pars.popsize);
+    BOOST_CHECK(pop2.getNClasses() > 2u);
+    BOOST_CHECK(pop2.getNClasses() <= pars.popsize);
+
+}
+
+// Test that a population of classes records population-level outputs like one of individuals
+BOOST_AUTO_TEST_CASE(populationCanPrintWithCohorts) {
+
+    // Parameters
+    Parameters pars;
+
+    // Tweak
+    pars.popsize = 100u;
+    pars.nrounds = 2u;
+    pars.tsave = 1u;
+    pars.cohorts = true;
+
+    // Population
+    Population pop(pars);
+
+    // Printer
+    Printer print({"resourceCensus", "habitatCensus", "traitMean"});
+    print.open();
+    pop.cycle(print);
+    print.close();
+
+    // Read values back in
+    std::vector<double> resourceCensus = tst::read("resourceCensus.dat");
+    std::vector<double> habitatCensus = tst::read("habitatCensus.dat");
+    std::vector<double> traitMean = tst::read("traitMean.dat");
+
+    // Check sizes
+    BOOST_REQUIRE_EQUAL(resourceCensus.size(), 8u);
+    BOOST_REQUIRE_EQUAL(habitatCensus.size(), 2u);
+    BOOST_REQUIRE_EQUAL(traitMean.size(), 1u);
+
+    // Everybody feeds in the first habitat in every round
+    BOOST_CHECK_EQUAL(resourceCensus[0u] + resourceCensus[1u], 100.0);
+    BOOST_CHECK_EQUAL(resourceCensus[2u] + resourceCensus[3u], 0.0);
+    BOOST_CHECK_EQUAL(resourceCensus[4u] + resourceCensus[5u], 100.0);
+    BOOST_CHECK_EQUAL(habitatCensus[0u], 100.0);
+    BOOST_CHECK_EQUAL(traitMean[0u], pars.xstart);
+
+    // Remove files
+    std::remove("resourceCensus.dat");
+    std::remove("habitatCensus.dat");
+    std::remove("traitMean.dat");
+
+}
+
+// Test that prefetching individuals ahead in the feeding queue does not change the outcome
+BOOST_AUTO_TEST_CASE(populationCycleIndependentOfPrefetching) {
+
+    // Parameters
+    Parameters pars;
+
+    // Tweak
+    pars.popsize = 1000u;
+    pars.hsymmetry = 0.5;
+    pars.dispersal = 0.1;
+    pars.mutrate = 0.1;
+    pars.mutsdev = 0.1;
+    pars.seed = 42u;
+
+    // Printer
+    Printer print({"foo", "bar"});
+
+    // With one thread and then with two
+    for (size_t n = 1u; n <= 2u; ++n) {
+
+        // Number of threads
+        pars.nthreads = n;
+
+        // Run without prefetching
+        pars.prefetch = 0u;
+        rnd::rng.seed(pars.seed);
+        Population pop1(pars);
+        for (size_t t = 0u; t < 3u; ++t, pop1.moveon()) pop1.cycle(print);
+
+        // And with
+        pars.prefetch = 4u;
+        rnd::rng.seed(pars.seed);
+        Population pop2(pars);
+        for (size_t t = 0u; t < 3u; ++t, pop2.moveon()) pop2.cycle(print);
+
+        // Check that the populations are the same
+        for (size_t i = 0u; i < pars.popsize; ++i) {
+            BOOST_REQUIRE_EQUAL(pop1.getX(i), pop2.getX(i));
+            BOOST_REQUIRE_EQUAL(pop1.getHabitat(i), pop2.getHabitat(i));
+        }
+    }
+}
+
+// Test that the population stays sorted by habitat through dispersal
+BOOST_AUTO_TEST_CASE(populationStaysSortedByHabitat) {
+
+    // Parameters
+    Parameters pars;
+
+    // Tweak (with enough individuals for several chunks)
+    pars.popsize = 10000u;
+    pars.hsymmetry = 0.5;
+    pars.dispersal = 0.3;
+    pars.mutrate = 0.1;
+    pars.mutsdev = 0.1;
+    pars.nthreads = 2u;
+    pars.seed = 42u;
+
+    // Printer
+    Printer print({"foo", "bar"});
+
+    // With each mode of reproduction
+    for (size_t m = 0u; m < 2u; ++m) {
+
+        // Create a population
+        pars.multinomial = m;
+        Population pop(pars);
+
+        // Cycle
+        for (size_t t = 0u; t < 3u; ++t, pop.moveon()) pop.cycle(print);
+
+        // Count the individuals in the second habitat
+        size_t n = 0u;
+        for (size_t i = 0u; i < pars.popsize; ++i) n += pop.getHabitat(i);
+
+        // Check that both habitats are occupied
+        BOOST_CHECK(n > 0u);
+        BOOST_CHECK(n < pars.popsize);
+
+        // Check that everyone in the first habitat comes first
+        for (size_t i = 0u; i < pars.popsize; ++i)
+            BOOST_REQUIRE_EQUAL(pop.getHabitat(i), i >= pars.popsize - n);
+
+    }
+}
+
+// Test that recording data does not change the course of the simulation
+BOOST_AUTO_TEST_CASE(populationCycleIndependentOfRecording) {
+
+    // Note: realized fitness is computed in a separate pass when data
+    // are recorded, and on the way through the next round otherwise.
+
+    // Parameters
+    Parameters pars;
+
+    // Tweak
+    pars.popsize = 1000u;
+    pars.hsymmetry = 0.5;
+    pars.dispersal = 0.1;
+    pars.mutrate = 0.1;
+    pars.mutsdev = 0.1;
+    pars.nrounds = 5u;
+    pars.tsave = 1u;
+    pars.seed = 42u;
+
+    // Printer that records every generation
+    Printer print1({"traitMean"});
+    print1.open();
+
+    // And one that does not
+    Printer print2({"traitMean"});
+
+    // Run while recording
+    rnd::rng.seed(pars.seed);
+    Population pop1(pars);
+    for (size_t t = 0u; t < 3u; ++t, pop1.moveon()) pop1.cycle(print1);
+
+    // And without
+    rnd::rng.seed(pars.seed);
+    Population pop2(pars);
+    for (size_t t = 0u; t < 3u; ++t, pop2.moveon()) pop2.cycle(print2);
+
+    // Close the printer
+    print1.close();
+
+    // Check that the populations are the same
+    for (size_t i = 0u; i < pars.popsize; ++i) {
+        BOOST_REQUIRE_EQUAL(pop1.getX(i), pop2.getX(i));
+        BOOST_REQUIRE_EQUAL(pop1.getHabitat(i), pop2.getHabitat(i));
+    }
+
+    // Remove files
+    std::remove("traitMean.dat");
+
+}
+
+// Test feeding in blocks of individuals choosing at the same time
+BOOST_AUTO_TEST_CASE(populationFeedingInBlocks) {
+
+    // Parameters
+    Parameters pars;
+
+    // Tweak (accurate choice, with one resource richer than the other)
+    pars.popsize = 1000u;
+    pars.hsymmetry = 0.5;
+    pars.beta = 1.0;
+    pars.nrounds = 1u;
+    pars.tend = 1u;
+    pars.seed = 42u;
+
+    // With the exact model and with everyone in one block
+    for (size_t b = 0u; b < 2u; ++b) {
+
+        // Block size
+        pars.blocksize = b ? pars.popsize : 1u;
+
+        // Population
+        rnd::rng.seed(pars.seed);
+        Population pop(pars);
+
+        // Printer
+        Printer print({"resourceCensus"});
+        print.open();
+
+        // Cycle
+        pop.cycle(print);
+
+        // Close the printer
+        print.close();
+
+        // Read values back in
+        std::vector<double> census = tst::read("resourceCensus.dat");
+        BOOST_REQUIRE_EQUAL(census.size(), 4u);
+
+        // Check that everyone is in the first habitat
+        BOOST_CHECK_EQUAL(census[0u] + census[1u], pars.popsize);
+
+        // In the exact model, the poorer resource gets used once the richer one is crowded
+        if (!b) BOOST_CHECK(census[1u] > 0.0);
+
+        // But in one block everyone goes for the richer one, as nobody has chosen yet
+        if (b) BOOST_CHECK_EQUAL(census[0u], pars.popsize);
+
+        // Remove files
+        std::remove("resourceCensus.dat");
+
+    }
+
+    // Tweak further (with enough individuals to share blocks across threads)
+    pars.popsize = 5000u;
+    pars.blocksize = 1000u;
+    pars.beta = 0.8;
+    pars.dispersal = 0.1;
+    pars.mutrate = 0.1;
+    pars.mutsdev = 0.1;
+    pars.nrounds = 3u;
+    pars.prefetch = 4u;
+
+    // Printer
+    Printer print({"foo", "bar"});
+
+    // Run with one thread...
+    pars.nthreads = 1u;
+    rnd::rng.seed(pars.seed);
+    Population pop1(pars);
+    for (size_t t = 0u; t < 3u; ++t, pop1.moveon()) pop1.cycle(print);
+
+    // ... and with three
+    pars.nthreads = 3u;
+    rnd::rng.seed(pars.seed);
+    Population pop2(pars);
+    for (size_t t = 0u; t < 3u; ++t, pop2.moveon()) pop2.cycle(print);
+
+    // Check that the populations are the same
+    for (size_t i = 0u; i < pars.popsize; ++i) {
+        BOOST_REQUIRE_EQUAL(pop1.getX(i), pop2.getX(i));
+        BOOST_REQUIRE_EQUAL(pop1.getHabitat(i), pop2.getHabitat(i));
+    }
+}
+
+// Test that feeding by guessing ahead across threads is exact
+BOOST_AUTO_TEST_CASE(populationSpeculativeFeedingIsExact) {
+
+    // Parameters
+    Parameters pars;
+
+    // Tweak (with enough individuals for several pieces per window)
+    pars.popsize = 10000u;
+    pars.hsymmetry = 0.5;
+    pars.beta = 0.8;
+    pars.dispersal = 0.1;
+    pars.mutrate = 0.1;
+    pars.mutsdev = 0.1;
+    pars.nrounds = 3u;
+    pars.tsave = 2u;
+    pars.speculate = true;
+    pars.seed = 42u;
+
+    // Data saved with one thread and with three
+    std::array<std::vector<double>, 2u> saved;
+
+    // Populations
+    std::vector<std::unique_ptr<Population> > pops;
+
+    // With one thread and then with three
+    for (size_t k = 0u; k < 2u; ++k) {
+
+        // Number of threads
+        pars.nthreads = k ? 3u : 1u;
+
+        // Population
+        rnd::rng.seed(pars.seed);
+        pops.push_back(std::make_unique<Population>(pars));
+
+        // Printer (recording every other generation)
+        Printer print({"individualExpectedFitnessDifference"});
+        print.open();
+
+        // Cycle
+        for (size_t t = 0u; t < 4u; ++t, pops.back()->moveon()) pops.back()->cycle(print);
+
+        // Close the printer
+        print.close();
+
+        // Read values back in
+        saved[k] = tst::read("individualExpectedFitnessDifference.dat");
+
+        // Remove files
+        std::remove("individualExpectedFitnessDifference.dat");
+
+    }
+
+    // Check that the same data were recorded
+    BOOST_REQUIRE_EQUAL(saved[0u].size(), 2u * pars.nrounds * pars.popsize);
+    BOOST_REQUIRE(saved[0u] == saved[1u]);
+
+    // Check that the populations are the same
+    for (size_t i = 0u; i < pars.popsize; ++i) {
+        BOOST_REQUIRE_EQUAL(pops[0u]->getX(i), pops[1u]->getX(i));
+        BOOST_REQUIRE_EQUAL(pops[0u]->getHabitat(i), pops[1u]->getHabitat(i));
+    }
+}
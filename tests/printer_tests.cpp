@@ -152,6 +152,67 @@ BOOST_AUTO_TEST_CASE(savingIntoBuffers) {
 
 }
 
+// Test that saving through channel handles works
+BOOST_AUTO_TEST_CASE(savingThroughChannels) {
+
+    // Set the list of buffer names
+    std::vector<std::string> valid = {"foo", "bar", "baz"};
+
+    // Create a printer
+    Printer print(valid);
+
+    // Only save some of them
+    tst::write("whattosave.txt", "baz\nfoo");
+    print.read("whattosave.txt");
+    print.open();
+
+    // Look up the channels
+    const size_t foo = print.find("foo");
+    const size_t bar = print.find("bar");
+    const size_t baz = print.find("baz");
+    const size_t qux = print.find("qux");
+
+    // Check that handles follow the list of valid names
+    BOOST_CHECK_EQUAL(foo, 0u);
+    BOOST_CHECK_EQUAL(bar, 1u);
+    BOOST_CHECK_EQUAL(baz, 2u);
+    BOOST_CHECK_EQUAL(qux, 3u);
+
+    // Check which channels are saved
+    BOOST_CHECK(print.saves(foo));
+    BOOST_CHECK(!print.saves(bar));
+    BOOST_CHECK(print.saves(baz));
+    BOOST_CHECK(!print.saves(qux));
+
+    // Save through the handles (and by name)
+    print.save(foo, 1.0);
+    print.save(bar, 2.0);
+    print.save(qux, 3.0);
+    print.save("foo", 4.0);
+    print.save(baz, 5.0);
+
+    // Close
+    print.close();
+
+    // Check that only the channels being saved got their values
+    const std::vector<double> foos = tst::read("foo.dat");
+    const std::vector<double> bazs = tst::read("baz.dat");
+    BOOST_CHECK_EQUAL(foos.size(), 2u);
+    BOOST_CHECK_EQUAL(foos[0u], 1.0);
+    BOOST_CHECK_EQUAL(foos[1u], 4.0);
+    BOOST_CHECK_EQUAL(bazs.size(), 1u);
+    BOOST_CHECK_EQUAL(bazs[0u], 5.0);
+
+    // Check that no file was made for the others
+    BOOST_CHECK(!std::ifstream("bar.dat").good());
+
+    // Remove files
+    std::remove("whattosave.txt");
+    std::remove("foo.dat");
+    std::remove("baz.dat");
+
+}
+
 // Test memory to size conversion
 BOOST_AUTO_TEST_CASE(convertMemoryToSize) {
 
@@ -183,4 +244,175 @@ BOOST_AUTO_TEST_CASE(initializeWithCustomSize) {
     std::remove("bar.dat");
     std::remove("baz.dat");
 
-}
\ No newline at end of file
+}
+
+// Test that outputs are written with their own types
+BOOST_AUTO_TEST_CASE(printerWritesTypedOutputs) {
+
+    // Set the list of buffer names and their types
+    std::vector<std::string> valid = {"foo", "bar", "baz"};
+    std::vector<prt::Type> types = {prt::bit, prt::u32, prt::f64};
+
+    // Create a printer
+    Printer print(valid, 1.0, types);
+
+    // Open
+    print.open();
+
+    // Check that buffers take up the same memory whatever their type
+    BOOST_CHECK_EQUAL(print.capacity("foo"), prt::memtosize(1.0, 1E6) * 64u);
+    BOOST_CHECK_EQUAL(print.capacity("bar"), prt::memtosize(1.0, 1E6) * 2u);
+    BOOST_CHECK_EQUAL(print.capacity("baz"), prt::memtosize(1.0, 1E6));
+
+    // Save some values
+    for (size_t i = 0u; i < 10u; ++i) {
+        print.save("foo", static_cast<double>(i % 2u));
+        print.save("bar", static_cast<double>(i));
+        print.save("baz", i / 10.0);
+    }
+
+    // Close
+    print.close();
+
+    // Read the data back in
+    const std::vector<double> foos = tst::read("foo.dat", prt::bit);
+    const std::vector<double> bars = tst::read("bar.dat", prt::u32);
+    const std::vector<double> bazs = tst::read("baz.dat", prt::f64);
+
+    // Check
+    BOOST_REQUIRE_EQUAL(foos.size(), 16u);
+    BOOST_REQUIRE_EQUAL(bars.size(), 10u);
+    BOOST_REQUIRE_EQUAL(bazs.size(), 10u);
+    for (size_t i = 0u; i < 10u; ++i) {
+        BOOST_CHECK_EQUAL(foos[i], static_cast<double>(i % 2u));
+        BOOST_CHECK_EQUAL(bars[i], static_cast<double>(i));
+        BOOST_CHECK_EQUAL(bazs[i], i / 10.0);
+    }
+
+    // Remove files
+    std::remove("foo.dat");
+    std::remove("bar.dat");
+    std::remove("baz.dat");
+
+}
+
+// Test that the printer reads error bounds
+BOOST_AUTO_TEST_CASE(printerReadsErrorBounds) {
+
+    // Set the list of buffer names and their types
+    std::vector<std::string> valid = {"foo", "bar", "baz"};
+    std::vector<prt::Type> types = {prt::f64, prt::u32, prt::f64};
+
+    // Create a printer
+    Printer print(valid, 1.0, types);
+
+    // Request outputs, one with an error bound (on the same line or not)
+    tst::write("whattosave.txt", "baz foo\n0.001\n");
+    print.read("whattosave.txt");
+
+    // Check
+    BOOST_CHECK_EQUAL(print.bound("foo"), 0.001);
+    BOOST_CHECK_EQUAL(print.bound("bar"), 0.0);
+    BOOST_CHECK_EQUAL(print.bound("baz"), 0.0);
+    BOOST_CHECK_EQUAL(print.bound("qux"), 0.0);
+
+    // Save some values
+    print.open();
+    for (size_t i = 0u; i < 10u; ++i) {
+        print.save("foo", i / 3.0);
+        print.save("baz", i / 3.0);
+    }
+    print.close();
+
+    // Check that they are read back within the bound
+    const std::vector<double> foos = tst::read("foo.dat", prt::f64, true);
+    const std::vector<double> bazs = tst::read("baz.dat");
+    BOOST_REQUIRE_EQUAL(foos.size(), 10u);
+    BOOST_REQUIRE_EQUAL(bazs.size(), 10u);
+    for (size_t i = 0u; i < 10u; ++i) {
+        BOOST_CHECK_LE(std::abs(foos[i] - i / 3.0), 0.001);
+        BOOST_CHECK_EQUAL(bazs[i], i / 3.0);
+    }
+
+    // Reading again forgets the bounds
+    tst::write("whattosave.txt", "foo");
+    print.read("whattosave.txt");
+    BOOST_CHECK_EQUAL(print.bound("foo"), 0.0);
+
+    // Remove files
+    std::remove("whattosave.txt");
+    std::remove("foo.dat");
+    std::remove("baz.dat");
+
+}
+
+// Test that invalid error bounds are caught
+BOOST_AUTO_TEST_CASE(printerFailsWhenInvalidErrorBound) {
+
+    // Set the list of buffer names and their types
+    std::vector<std::string> valid = {"foo", "bar"};
+    std::vector<prt::Type> types = {prt::f64, prt::u32};
+
+    // Create a printer
+    Printer print(valid, 1.0, types);
+
+    // Bounds that are not strictly positive
+    for (const std::string &bound : std::vector<std::string>{"0", "-1", "-0.001"}) {
+        tst::write("whattosave.txt", "foo " + bound);
+        tst::checkError([&]() {
+            print.read("whattosave.txt");
+        }, "Invalid error bound for output foo in whattosave.txt");
+    }
+
+    // Words that are neither bounds nor outputs (or bounds without an output)
+    for (const std::string &word : std::vector<std::string>{"1e-3x", "abc", "2"}) {
+        tst::write("whattosave.txt", "foo 1 " + word);
+        tst::checkError([&]() {
+            print.read("whattosave.txt");
+        }, "Invalid output requested in whattosave.txt: " + word);
+    }
+
+    // Bound on an output that is not saved as doubles
+    tst::write("whattosave.txt", "bar 0.1");
+    tst::checkError([&]() {
+        print.read("whattosave.txt");
+    }, "Output bar cannot be given an error bound in whattosave.txt");
+
+    // Remove files
+    std::remove("whattosave.txt");
+
+}
+
+// Test that the channels of the outputs of the simulation are looked up once made
+BOOST_AUTO_TEST_CASE(printerResolvesOutputChannels) {
+
+    // Check that the list of outputs matches their enumeration
+    const std::vector<std::string> names = out::names();
+    BOOST_REQUIRE_EQUAL(names.size(), out::noutputs);
+    BOOST_CHECK_EQUAL(names[out::time], "time");
+    BOOST_CHECK_EQUAL(names[out::individualChoice], "individualChoice");
+    BOOST_CHECK_EQUAL(names[out::traitStandardDeviation], "traitStandardDeviation");
+
+    // Check that their types follow the same list
+    const std::vector<prt::Type> types = out::types();
+    BOOST_REQUIRE_EQUAL(types.size(), out::noutputs);
+    BOOST_CHECK_EQUAL(types[out::time], prt::u32);
+    BOOST_CHECK_EQUAL(types[out::individualChoice], prt::bit);
+    BOOST_CHECK_EQUAL(types[out::traitStandardDeviation], prt::f64);
+
+    // Create a printer with only some of them (in another order)
+    Printer print({"habitatCensus", "time"});
+
+    // Check that their handles follow the list of valid names
+    BOOST_CHECK_EQUAL(print.channel(out::habitatCensus), 0u);
+    BOOST_CHECK_EQUAL(print.channel(out::time), 1u);
+
+    // Check that the others are never saved (and not saved as something else)
+    BOOST_CHECK_EQUAL(print.channel(out::traitMean), 2u);
+    BOOST_CHECK_EQUAL(print.channel(out::individualChoice), 2u);
+
+    // Check with all of them
+    Printer all(names);
+    for (size_t o = 0u; o < out::noutputs; ++o) BOOST_CHECK_EQUAL(all.channel(static_cast<out::Output>(o)), o);
+
+}
@@ -0,0 +1,341 @@
+#define BOOST_TEST_DYNAMIC_LINK
+#define BOOST_TEST_MODULE Main
+
+// Here we test the random sampling utilities.
+
+#include "../src/random.hpp"
+#include <boost/test/unit_test.hpp>
+
+// Test that the alias table samples proportionately to the weights (PROBABILISTIC)
+BOOST_AUTO_TEST_CASE(aliasSamplesProportionately) {
+
+    // Seed the generator
+    rnd::rng.seed(42u);
+
+    // Weights
+    const std::vector<double> weights = {1.0, 0.0, 3.0, 4.0};
+
+    // Build the table
+    rnd::Alias sample(weights.size());
+    sample.build(weights);
+
+    // Count draws
+    std::vector<size_t> counts(weights.size(), 0u);
+    const size_t n = 100000u;
+    for (size_t i = 0u; i < n; ++i) ++counts[sample(rnd::rng)];
+
+    // Check frequencies
+    BOOST_CHECK_CLOSE(counts[0u] / static_cast<double>(n), 0.125, 5.0);
+    BOOST_CHECK_EQUAL(counts[1u], 0u);
+    BOOST_CHECK_CLOSE(counts[2u] / static_cast<double>(n), 0.375, 5.0);
+    BOOST_CHECK_CLOSE(counts[3u] / static_cast<double>(n), 0.5, 5.0);
+
+}
+
+// Test that the alias table samples uniformly if all weights are zero (PROBABILISTIC)
+BOOST_AUTO_TEST_CASE(aliasSamplesUniformlyWithoutWeights) {
+
+    // Seed the generator
+    rnd::rng.seed(42u);
+
+    // Build the table
+    rnd::Alias sample(2u);
+    sample.build({0.0, 0.0});
+
+    // Count draws
+    size_t count = 0u;
+    const size_t n = 10000u;
+    for (size_t i = 0u; i < n; ++i) count += sample(rnd::rng);
+
+    // Check frequency
+    BOOST_CHECK_CLOSE(count / static_cast<double>(n), 0.5, 5.0);
+
+}
+
+// Test that the alias table always returns the only index with weight
+BOOST_AUTO_TEST_CASE(aliasSamplesSingleWeight) {
+
+    // Build the table
+    rnd::Alias sample(3u);
+    sample.build({0.0, 2.0, 0.0});
+
+    // Check
+    for (size_t i = 0u; i < 100u; ++i) BOOST_CHECK_EQUAL(sample(rnd::rng), 1u);
+
+}
+
+// Test that rebuilding the alias table does not reallocate
+BOOST_AUTO_TEST_CASE(aliasRebuildsInPlace) {
+
+    // Build a table
+    rnd::Alias sample(4u);
+    sample.build({1.0, 2.0, 3.0, 4.0});
+
+    // Check
+    BOOST_CHECK_EQUAL(sample.size(), 4u);
+    BOOST_CHECK_EQUAL(sample.capacity(), 4u);
+
+    // Rebuild with other weights
+    sample.build({4.0, 0.0, 1.0, 1.0});
+
+    // Check that the capacity has not changed
+    BOOST_CHECK_EQUAL(sample.size(), 4u);
+    BOOST_CHECK_EQUAL(sample.capacity(), 4u);
+
+}
+
+// Test that the alias table gives the same draws from single precision weights
+BOOST_AUTO_TEST_CASE(aliasTakesSinglePrecisionWeights) {
+
+    // The same weights in both precisions (exactly representable)
+    const std::vector<double> weights = {0.5, 0.0, 1.5, 2.0};
+    const std::vector<float> singles(weights.begin(), weights.end());
+
+    // Build the tables
+    rnd::Alias sample(4u);
+    rnd::Alias other(4u);
+    sample.build(weights);
+    other.build(singles);
+
+    // Check that they sample the same indices
+    rnd::rng.seed(42u);
+    std::mt19937_64 copy(rnd::rng);
+    for (size_t i = 0u; i < 1000u; ++i) BOOST_CHECK_EQUAL(sample(rnd::rng), other(copy));
+
+}
+
+// Test that skipping between successes gives the right number of successes (PROBABILISTIC)
+BOOST_AUTO_TEST_CASE(successesHaveTheRightFrequency) {
+
+    // Seed the generator
+    rnd::rng.seed(42u);
+
+    // Count successes and keep track of their order
+    size_t count = 0u;
+    size_t previous = 0u;
+    bool ordered = true;
+
+    // Visit successes
+    rnd::successes(100000u, 0.1, rnd::rng, [&](const size_t &i) {
+        if (count && i <= previous) ordered = false;
+        previous = i;
+        ++count;
+    });
+
+    // Check
+    BOOST_CHECK(ordered);
+    BOOST_CHECK(previous < 100000u);
+    BOOST_CHECK_CLOSE(count / 100000.0, 0.1, 5.0);
+
+}
+
+// Test the edge cases of skipping between successes
+BOOST_AUTO_TEST_CASE(successesEdgeCases) {
+
+    // Count successes
+    size_t count = 0u;
+    auto visit = [&](const size_t&) { ++count; };
+
+    // No success if impossible
+    rnd::successes(100u, 0.0, rnd::rng, visit);
+    BOOST_CHECK_EQUAL(count, 0u);
+
+    // All successes if certain
+    rnd::successes(100u, 1.0, rnd::rng, visit);
+    BOOST_CHECK_EQUAL(count, 100u);
+
+    // No trials, no successes
+    count = 0u;
+    rnd::successes(0u, 0.5, rnd::rng, visit);
+    BOOST_CHECK_EQUAL(count, 0u);
+
+}
+
+// Test the counter-based generator against known answers (Random123 test vectors)
+BOOST_AUTO_TEST_CASE(philoxKnownAnswers) {
+
+    // Zero counter and key
+    const auto out1 = rnd::Philox::hash({0u, 0u, 0u, 0u}, {0u, 0u});
+    BOOST_CHECK_EQUAL(out1[0u], 0x6627e8d5u);
+    BOOST_CHECK_EQUAL(out1[1u], 0xe169c58du);
+    BOOST_CHECK_EQUAL(out1[2u], 0xbc57ac4cu);
+    BOOST_CHECK_EQUAL(out1[3u], 0x9b00dbd8u);
+
+    // Maximal counter and key
+    const auto out2 = rnd::Philox::hash({0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu}, {0xffffffffu, 0xffffffffu});
+    BOOST_CHECK_EQUAL(out2[0u], 0x408f276du);
+    BOOST_CHECK_EQUAL(out2[1u], 0x41c83b0eu);
+    BOOST_CHECK_EQUAL(out2[2u], 0xa20bc7c6u);
+    BOOST_CHECK_EQUAL(out2[3u], 0x6d5451fdu);
+
+    // Digits of pi
+    const auto out3 = rnd::Philox::hash({0x243f6a88u, 0x85a308d3u, 0x13198a2eu, 0x03707344u}, {0xa4093822u, 0x299f31d0u});
+    BOOST_CHECK_EQUAL(out3[0u], 0xd16cfe09u);
+    BOOST_CHECK_EQUAL(out3[1u], 0x94fdccebu);
+    BOOST_CHECK_EQUAL(out3[2u], 0x5001e420u);
+    BOOST_CHECK_EQUAL(out3[3u], 0x24126ea1u);
+
+}
+
+// Test that streams are reproducible and distinct
+BOOST_AUTO_TEST_CASE(philoxStreams) {
+
+    // Two identical streams
+    rnd::Philox gen1(42u, 3u, 1u, 7u);
+    rnd::Philox gen2(42u, 3u, 1u, 7u);
+
+    // Streams differing by one coordinate
+    rnd::Philox gen3(42u, 3u, 1u, 8u);
+    rnd::Philox gen4(42u, 3u, 2u, 7u);
+    rnd::Philox gen5(42u, 4u, 1u, 7u);
+    rnd::Philox gen6(43u, 3u, 1u, 7u);
+
+    // Check
+    for (size_t i = 0u; i < 10u; ++i) {
+
+        const uint64_t x = gen1();
+        BOOST_CHECK_EQUAL(x, gen2());
+        BOOST_CHECK(x != gen3());
+        BOOST_CHECK(x != gen4());
+        BOOST_CHECK(x != gen5());
+        BOOST_CHECK(x != gen6());
+
+    }
+}
+
+// Test that the counter-based generator works with standard distributions (PROBABILISTIC)
+BOOST_AUTO_TEST_CASE(philoxWithDistributions) {
+
+    // Generator
+    rnd::Philox gen(42u);
+
+    // Sample uniform numbers
+    double sum = 0.0;
+    const size_t n = 100000u;
+    for (size_t i = 0u; i < n; ++i) sum += rnd::uniform(0.0, 1.0)(gen);
+
+    // Check the mean
+    BOOST_CHECK_CLOSE(sum / n, 0.5, 1.0);
+
+}
+
+// Test that coin flips from the counter-based generator are fair (PROBABILISTIC)
+BOOST_AUTO_TEST_CASE(philoxFlipsFairCoins) {
+
+    // Generator
+    rnd::Philox gen(42u);
+
+    // Count heads
+    size_t count = 0u;
+    const size_t n = 100000u;
+    for (size_t i = 0u; i < n; ++i) count += gen.flip();
+
+    // Check the frequency
+    BOOST_CHECK_CLOSE(count / static_cast<double>(n), 0.5, 1.0);
+
+}
+
+// Test that the counter-based generator can jump within its stream
+BOOST_AUTO_TEST_CASE(philoxSeeks) {
+
+    // Generators
+    rnd::Philox gen1(42u, 1u, 2u, 3u);
+    rnd::Philox gen2(42u, 1u, 2u, 3u);
+
+    // Move the first one along (two outputs per block)
+    for (size_t i = 0u; i < 10u; ++i) gen1();
+
+    // And make the second one jump there
+    gen2.flip();
+    gen2.seek(5u);
+
+    // Check that they give the same numbers from there on
+    for (size_t i = 0u; i < 10u; ++i) BOOST_CHECK_EQUAL(gen1(), gen2());
+
+    // Check that jumping back gives the same numbers again
+    gen2.seek(5u);
+    rnd::Philox gen3(42u, 1u, 2u, 3u);
+    gen3.seek(5u);
+    for (size_t i = 0u; i < 10u; ++i) BOOST_CHECK_EQUAL(gen2(), gen3());
+
+}
+
+// Test that the last block of a stream can still be used
+BOOST_AUTO_TEST_CASE(philoxReachesTheEndOfItsStream) {
+
+    // Generator
+    rnd::Philox gen(42u, 1u, 2u, 3u);
+
+    // Jump to the last block
+    gen.seek(UINT32_MAX);
+
+    // Expected block
+    const auto block = rnd::Philox::hash({UINT32_MAX, 3u, 2u, 1u}, {42u, 0u});
+
+    // Check that both of its outputs come out (the next one would be out of the stream)
+    BOOST_CHECK_EQUAL(gen(), block[0u] | (static_cast<uint64_t>(block[1u]) << 32u));
+    BOOST_CHECK_EQUAL(gen(), block[2u] | (static_cast<uint64_t>(block[3u]) << 32u));
+
+}
+
+// Test that emptying an urn draws every ball once
+BOOST_AUTO_TEST_CASE(urnDrawsEveryBallOnce) {
+
+    // Generator
+    rnd::Philox gen(42u);
+
+    // Fill the urn
+    const std::vector<size_t> counts = {3u, 0u, 1u, 7u, 2u};
+    rnd::Urn urn;
+    for (const size_t &n : counts) urn.add(n);
+    urn.build();
+
+    // Check
+    BOOST_CHECK_EQUAL(urn.size(), 5u);
+    BOOST_CHECK_EQUAL(urn.total(), 13u);
+
+    // Empty it
+    std::vector<size_t> drawn(counts.size(), 0u);
+    while (urn.total()) ++drawn[urn(gen)];
+
+    // Check that every ball came out
+    for (size_t i = 0u; i < counts.size(); ++i) BOOST_CHECK_EQUAL(drawn[i], counts[i]);
+
+    // Refill it
+    urn.clear();
+    urn.add(2u);
+    urn.build();
+
+    // Check
+    BOOST_CHECK_EQUAL(urn.size(), 1u);
+    BOOST_CHECK_EQUAL(urn(gen), 0u);
+    BOOST_CHECK_EQUAL(urn(gen), 0u);
+    BOOST_CHECK_EQUAL(urn.total(), 0u);
+
+}
+
+// Test that the urn draws kinds proportionately to what is left (PROBABILISTIC)
+BOOST_AUTO_TEST_CASE(urnDrawsProportionately) {
+
+    // Generator
+    rnd::Philox gen(42u);
+
+    // Count the kinds of first draws
+    std::vector<size_t> counts(3u, 0u);
+    const size_t n = 100000u;
+    rnd::Urn urn;
+    for (size_t i = 0u; i < n; ++i) {
+        urn.clear();
+        urn.add(1u);
+        urn.add(3u);
+        urn.add(4u);
+        urn.build();
+        ++counts[urn(gen)];
+    }
+
+    // Check frequencies
+    BOOST_CHECK_CLOSE(counts[0u] / static_cast<double>(n), 0.125, 5.0);
+    BOOST_CHECK_CLOSE(counts[1u] / static_cast<double>(n), 0.375, 5.0);
+    BOOST_CHECK_CLOSE(counts[2u] / static_cast<double>(n), 0.5, 5.0);
+
+}
@@ -0,0 +1,142 @@
+#define BOOST_TEST_DYNAMIC_LINK
+#define BOOST_TEST_MODULE Main
+
+// Here we test the column storage of individuals.
+
+#include "../src/storage.hpp"
+#include <boost/test/unit_test.hpp>
+
+// Test that an individual is stored and read back properly
+BOOST_AUTO_TEST_CASE(storageKeepsIndividuals) {
+
+    // Create an individual
+    Individual ind(0.5, 1.0);
+
+    // Tweak it
+    ind.disperse();
+    ind.setRank(7u);
+    ind.setDiff(0.25);
+
+    // Create a storage
+    Storage storage;
+
+    // Add the individual
+    storage.add(ind);
+
+    // Check size
+    BOOST_CHECK_EQUAL(storage.size(), 1u);
+
+    // Read it back
+    const Individual copy = storage.get(0u);
+
+    // Check attributes
+    BOOST_CHECK_EQUAL(copy.getX(), 0.5);
+    BOOST_CHECK_EQUAL(copy.getEff1(), ind.getEff1());
+    BOOST_CHECK_EQUAL(copy.getEff2(), ind.getEff2());
+    BOOST_CHECK_EQUAL(copy.getDiff(), 0.25);
+    BOOST_CHECK_EQUAL(copy.getRank(), 7u);
+    BOOST_CHECK(copy.getHabitat());
+    BOOST_CHECK(!copy.getEcotype());
+    BOOST_CHECK(!copy.getChoice());
+
+}
+
+// Test that cloning copies all attributes
+BOOST_AUTO_TEST_CASE(storageClonesIndividuals) {
+
+    // Create two storages
+    Storage adults;
+    Storage offspring;
+
+    // Fill the first one
+    adults.add(Individual(0.0, 1.0));
+    adults.add(Individual(1.0, 1.0));
+
+    // Modify the second individual
+    adults.disperse(1u);
+    adults.setChoice(1u, true);
+
+    // Clone it
+    offspring.clone(adults, 1u);
+
+    // Check
+    BOOST_CHECK_EQUAL(offspring.size(), 1u);
+    BOOST_CHECK_EQUAL(offspring.getX(0u), 1.0);
+    BOOST_CHECK_EQUAL(offspring.getEff2(0u), 1.0);
+    BOOST_CHECK(offspring.getHabitat(0u));
+    BOOST_CHECK(offspring.getChoice(0u));
+
+    // Clearing keeps the capacity
+    offspring.reserve(10u);
+    offspring.clear();
+    BOOST_CHECK(offspring.empty());
+    BOOST_CHECK_EQUAL(offspring.capacity(), 10u);
+
+}
+
+// Test that mutation in the storage matches mutation of an individual
+BOOST_AUTO_TEST_CASE(storageMutatesLikeIndividuals) {
+
+    // Create an individual
+    Individual ind(0.0, 1.0);
+
+    // Store it
+    Storage storage;
+    storage.add(ind);
+
+    // Mutate both
+    ind.mutate(0.1, 1.0);
+    storage.mutate(0u, 0.1, 1.0);
+
+    // Check that they agree
+    BOOST_CHECK_EQUAL(storage.getX(0u), ind.getX());
+    BOOST_CHECK_EQUAL(storage.getEff1(0u), ind.getEff1());
+    BOOST_CHECK_EQUAL(storage.getEff2(0u), ind.getEff2());
+
+}
+
+// Test ecotype assignment
+BOOST_AUTO_TEST_CASE(storageSetsEcotype) {
+
+    // Create a storage
+    Storage storage;
+    storage.add(Individual(-1.0, 1.0));
+    storage.add(Individual(1.0, 1.0));
+
+    // Set ecotypes relative to the mean
+    storage.setEcotype(0u, 0.0);
+    storage.setEcotype(1u, 0.0);
+
+    // Check
+    BOOST_CHECK(!storage.getEcotype(0u));
+    BOOST_CHECK(storage.getEcotype(1u));
+
+}
+
+// Test that the fractions of resources left undiscovered are kept up to date
+BOOST_AUTO_TEST_CASE(storageCachesUndiscoveredFractions) {
+
+    // Create a storage with some discovery rate
+    Storage storage(2.0);
+    storage.add(Individual(0.5, 1.0));
+
+    // Check
+    BOOST_CHECK_CLOSE(storage.getMiss1(0u), static_cast<utl::Real>(exp(-2.0 * storage.getEff1(0u))), 1e-12);
+    BOOST_CHECK_CLOSE(storage.getMiss2(0u), static_cast<utl::Real>(exp(-2.0 * storage.getEff2(0u))), 1e-12);
+
+    // Mutate
+    storage.mutate(0u, -1.0, 1.0);
+
+    // Check that the cache has been updated
+    BOOST_CHECK_CLOSE(storage.getMiss1(0u), static_cast<utl::Real>(exp(-2.0 * storage.getEff1(0u))), 1e-12);
+    BOOST_CHECK_CLOSE(storage.getMiss2(0u), static_cast<utl::Real>(exp(-2.0 * storage.getEff2(0u))), 1e-12);
+
+    // Copy over to another storage
+    Storage other(2.0);
+    other.clone(storage, 0u);
+
+    // Check
+    BOOST_CHECK_EQUAL(other.getMiss1(0u), storage.getMiss1(0u));
+    BOOST_CHECK_EQUAL(other.getMiss2(0u), storage.getMiss2(0u));
+
+}
@@ -91,7 +91,7 @@ BOOST_AUTO_TEST_CASE(useCaseUserDefinedOutput) {
     doMain({"program", "parameters.txt"});
 
     // Read the data if they exist
-    const std::vector<double> values = tst::read("time.dat");
+    const std::vector<double> values = tst::read("time.dat", prt::u32);
 
     // Check
     assert(!values.empty());
@@ -102,7 +102,7 @@ BOOST_AUTO_TEST_CASE(useCaseUserDefinedOutput) {
     
     // Check that no other output file was read
     tst::checkError([&] { 
-        tst::read("habitatCensus.dat"); 
+        tst::read("habitatCensus.dat", prt::u32); 
     }, "Unable to open file habitatCensus.dat");
     
     // Cleanup
@@ -138,35 +138,35 @@ BOOST_AUTO_TEST_CASE(useCaseAllOutputsIfNoChoice) {
     doMain({"program", "parameters.txt"});
 
     // Check that all output files can be read
-    BOOST_CHECK_NO_THROW(tst::read("time.dat"));
-    BOOST_CHECK_NO_THROW(tst::read("resourceCensus.dat"));
+    BOOST_CHECK_NO_THROW(tst::read("time.dat", prt::u32));
+    BOOST_CHECK_NO_THROW(tst::read("resourceCensus.dat", prt::u32));
     BOOST_CHECK_NO_THROW(tst::read("resourceMeanTraitValue.dat"));
     BOOST_CHECK_NO_THROW(tst::read("individualExpectedFitnessDifference.dat"));
-    BOOST_CHECK_NO_THROW(tst::read("individualChoice.dat"));
+    BOOST_CHECK_NO_THROW(tst::read("individualChoice.dat", prt::bit));
     BOOST_CHECK_NO_THROW(tst::read("individualRealizedFitness.dat"));
-    BOOST_CHECK_NO_THROW(tst::read("individualRank.dat"));
-    BOOST_CHECK_NO_THROW(tst::read("individualHabitat.dat"));
+    BOOST_CHECK_NO_THROW(tst::read("individualRank.dat", prt::u32));
+    BOOST_CHECK_NO_THROW(tst::read("individualHabitat.dat", prt::bit));
     BOOST_CHECK_NO_THROW(tst::read("individualTraitValue.dat"));
     BOOST_CHECK_NO_THROW(tst::read("individualTotalFitness.dat"));
-    BOOST_CHECK_NO_THROW(tst::read("individualEcotype.dat"));
-    BOOST_CHECK_NO_THROW(tst::read("habitatCensus.dat"));
+    BOOST_CHECK_NO_THROW(tst::read("individualEcotype.dat", prt::bit));
+    BOOST_CHECK_NO_THROW(tst::read("habitatCensus.dat", prt::u32));
     BOOST_CHECK_NO_THROW(tst::read("habitatMeanTraitValue.dat"));
     BOOST_CHECK_NO_THROW(tst::read("ecologicalIsolation.dat"));
     BOOST_CHECK_NO_THROW(tst::read("spatialIsolation.dat"));
 
-    // Check some values
-    BOOST_CHECK_EQUAL(tst::read("time.dat").size(), 11u);
-    BOOST_CHECK_EQUAL(tst::read("resourceCensus.dat").size(), 88u);
+    // Check some values (flags are packed into whole bytes)
+    BOOST_CHECK_EQUAL(tst::read("time.dat", prt::u32).size(), 11u);
+    BOOST_CHECK_EQUAL(tst::read("resourceCensus.dat", prt::u32).size(), 88u);
     BOOST_CHECK_EQUAL(tst::read("resourceMeanTraitValue.dat").size(), 88u);
     BOOST_CHECK_EQUAL(tst::read("individualExpectedFitnessDifference.dat").size(), 110u);
-    BOOST_CHECK_EQUAL(tst::read("individualChoice.dat").size(), 110u);
+    BOOST_CHECK_EQUAL(tst::read("individualChoice.dat", prt::bit).size(), 112u);
     BOOST_CHECK_EQUAL(tst::read("individualRealizedFitness.dat").size(), 110u);
-    BOOST_CHECK_EQUAL(tst::read("individualRank.dat").size(), 110u);
-    BOOST_CHECK_EQUAL(tst::read("individualHabitat.dat").size(), 55u);
+    BOOST_CHECK_EQUAL(tst::read("individualRank.dat", prt::u32).size(), 110u);
+    BOOST_CHECK_EQUAL(tst::read("individualHabitat.dat", prt::bit).size(), 56u);
     BOOST_CHECK_EQUAL(tst::read("individualTraitValue.dat").size(), 55u);
     BOOST_CHECK_EQUAL(tst::read("individualTotalFitness.dat").size(), 55u);
-    BOOST_CHECK_EQUAL(tst::read("individualEcotype.dat").size(), 55u);
-    BOOST_CHECK_EQUAL(tst::read("habitatCensus.dat").size(), 22u);
+    BOOST_CHECK_EQUAL(tst::read("individualEcotype.dat", prt::bit).size(), 56u);
+    BOOST_CHECK_EQUAL(tst::read("habitatCensus.dat", prt::u32).size(), 22u);
     BOOST_CHECK_EQUAL(tst::read("habitatMeanTraitValue.dat").size(), 22u);
     BOOST_CHECK_EQUAL(tst::read("ecologicalIsolation.dat").size(), 11u);
     BOOST_CHECK_EQUAL(tst::read("spatialIsolation.dat").size(), 11u);
@@ -191,6 +191,80 @@ BOOST_AUTO_TEST_CASE(useCaseAllOutputsIfNoChoice) {
 
 }
 
+// Test that compressed outputs read back to the uncompressed ones
+BOOST_AUTO_TEST_CASE(useCaseWithCompression) {
+
+    // Outputs to compare, with their types
+    const std::vector<std::string> names = {"time", "individualChoice", "individualRank", "individualTraitValue"};
+    const std::vector<prt::Type> types = {prt::u32, prt::bit, prt::u32, prt::f64};
+
+    // Write an output request file
+    tst::write("whattosave.txt", "time\nindividualChoice\nindividualRank\nindividualTraitValue");
+
+    // Run the simulation without compression
+    tst::write("parameters.txt", "popsize 50\ntend 10\ntsave 1\nsavedat 1\nchoose 1\nseed 42\nmemsave 0.001");
+    doMain({"program", "parameters.txt"});
+
+    // Read the outputs
+    std::vector<std::vector<double> > plain;
+    for (size_t i = 0u; i < names.size(); ++i) plain.push_back(tst::read(names[i] + ".dat", types[i]));
+
+    // Run it again with compression
+    tst::write("parameters.txt", "popsize 50\ntend 10\ntsave 1\nsavedat 1\nchoose 1\nseed 42\nmemsave 0.001\ncompress 1");
+    doMain({"program", "parameters.txt"});
+
+    // Check that the outputs read back to the same values
+    for (size_t i = 0u; i < names.size(); ++i) {
+        BOOST_CHECK(!plain[i].empty());
+        BOOST_CHECK(tst::read(names[i] + ".dat", types[i], true) == plain[i]);
+    }
+
+    // Cleanup
+    std::remove("parameters.txt");
+    std::remove("whattosave.txt");
+    for (const std::string &name : names) std::remove((name + ".dat").c_str());
+
+}
+
+// Test that outputs saved with an error bound stay within it
+BOOST_AUTO_TEST_CASE(useCaseWithErrorBounds) {
+
+    // Outputs to compare
+    const std::vector<std::string> names = {"individualTraitValue", "individualExpectedFitnessDifference", "individualRealizedFitness"};
+
+    // Run the simulation saving them exactly
+    tst::write("whattosave.txt", "individualTraitValue\nindividualExpectedFitnessDifference\nindividualRealizedFitness");
+    tst::write("parameters.txt", "popsize 50\ntend 10\ntsave 1\nsavedat 1\nchoose 1\nseed 42\nmutrate 0.1");
+    doMain({"program", "parameters.txt"});
+
+    // Read the outputs
+    std::vector<std::vector<double> > exact;
+    for (const std::string &name : names) exact.push_back(tst::read(name + ".dat"));
+
+    // Run it again with error bounds (and with or without compression)
+    for (const std::string compress : {"0", "1"}) {
+
+        tst::write("whattosave.txt", "individualTraitValue 1e-5\nindividualExpectedFitnessDifference 1e-5\nindividualRealizedFitness 0.001");
+        tst::write("parameters.txt", "popsize 50\ntend 10\ntsave 1\nsavedat 1\nchoose 1\nseed 42\nmutrate 0.1\ncompress " + compress);
+        doMain({"program", "parameters.txt"});
+
+        // Check that the outputs are within their bounds
+        for (size_t i = 0u; i < names.size(); ++i) {
+            const std::vector<double> values = tst::read(names[i] + ".dat", prt::f64, true);
+            const double bound = i == 2u ? 0.001 : 1E-5;
+            BOOST_REQUIRE_EQUAL(values.size(), exact[i].size());
+            for (size_t j = 0u; j < values.size(); ++j)
+                BOOST_CHECK_LE(std::abs(values[j] - exact[i][j]), bound);
+        }
+    }
+
+    // Cleanup
+    std::remove("parameters.txt");
+    std::remove("whattosave.txt");
+    for (const std::string &name : names) std::remove((name + ".dat").c_str());
+
+}
+
 // Test that nothing is saved if no data saving
 BOOST_AUTO_TEST_CASE(useCaseNothingIsSaved) {
 
@@ -201,8 +275,8 @@ BOOST_AUTO_TEST_CASE(useCaseNothingIsSaved) {
     doMain({"program", "parameters.txt"});
 
     // Check that none of the possible output files are present
-    tst::checkError([&] {tst::read("time.dat");}, "Unable to open file time.dat");
-    tst::checkError([&] {tst::read("resourceCensus.dat");}, "Unable to open file resourceCensus.dat");
+    tst::checkError([&] {tst::read("time.dat", prt::u32);}, "Unable to open file time.dat");
+    tst::checkError([&] {tst::read("resourceCensus.dat", prt::u32);}, "Unable to open file resourceCensus.dat");
     tst::checkError([&] {tst::read("individualExpectedFitnessDifference.dat");}, "Unable to open file individualExpectedFitnessDifference.dat");
 
     // Cleanup
@@ -227,4 +301,55 @@ BOOST_AUTO_TEST_CASE(useCaseWithVerbose) {
     // Cleanup
     std::remove("parameters.txt");
 
-}
\ No newline at end of file
+}
+// Test that individual-level outputs cannot be saved with cohorts
+BOOST_AUTO_TEST_CASE(abuseIndividualOutputWithCohorts) {
+
+    // Write an output request file
+    tst::write("whattosave.txt", "time individualTraitValue");
+
+    // Write a parameter file
+    tst::write("parameters.txt", "cohorts 1\nsavedat 1\nchoose 1\ntend 10\ntsave 1");
+
+    // Check error
+    tst::checkError([&] {
+        doMain({"program", "parameters.txt"});
+    }, "Output individualTraitValue cannot be saved with cohorts");
+
+    // Cleanup
+    std::remove("parameters.txt");
+    std::remove("whattosave.txt");
+    std::remove("time.dat");
+    std::remove("individualTraitValue.dat");
+
+}
+
+// Test that population-level outputs can be saved with cohorts
+BOOST_AUTO_TEST_CASE(useCaseWithCohorts) {
+
+    // Write an output request file
+    tst::write("whattosave.txt", "time habitatCensus");
+
+    // Write a parameter file
+    tst::write("parameters.txt", "popsize 100\ncohorts 1\nsavedat 1\nchoose 1\ntend 10\ntsave 1");
+
+    // Run the simulation
+    doMain({"program", "parameters.txt"});
+
+    // Read the data
+    const std::vector<double> time = tst::read("time.dat", prt::u32);
+    const std::vector<double> census = tst::read("habitatCensus.dat", prt::u32);
+
+    // Check
+    BOOST_CHECK_EQUAL(time.size(), 11u);
+    BOOST_REQUIRE_EQUAL(census.size(), 22u);
+    for (size_t i = 0u; i < census.size(); i += 2u)
+        BOOST_CHECK_EQUAL(census[i] + census[i + 1u], 100.0);
+
+    // Cleanup
+    std::remove("parameters.txt");
+    std::remove("whattosave.txt");
+    std::remove("time.dat");
+    std::remove("habitatCensus.dat");
+
+}
@@ -3,10 +3,15 @@
 #include "testutils.hpp"
 
 // Function to read a binary data file
-std::vector<double> tst::read(const std::string &filename)
+std::vector<double> tst::read(const std::string &filename, const prt::Type &type, const bool &compressed)
 {
 
     // filename: the name of the file to read
+    // type: the type the values were written as (see Buffer)
+    // compressed: whether the file is made of compressed chunks (see cdc)
+
+    // Note: files of bits are read back eight values per byte, so they come
+    // with the zeros padding their last byte.
 
     // Open the input file
     std::ifstream file(filename.c_str(), std::ios::in | std::ios::binary);
@@ -15,31 +20,42 @@ std::vector<double> tst::read(const std::string &filename)
     if (!file.is_open())
         throw std::runtime_error("Unable to open file " + filename);
 
-    // Prepare storage for values
-    double x;
-    std::vector<double> v;
+    // Read all the bytes
+    std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
 
-    // If the file is open
-    if (file.is_open()) {
+    // Decompress if needed
+    if (compressed) bytes = cdc::decode(bytes);
+
+    // Close the file
+    file.close();
 
-        // Loop through the file until we reach the end of the file
-        while(file) {
+    // Prepare storage for values
+    std::vector<double> v;
 
-            // Read elements
-            file.read((char *) &x, sizeof(size_t));
+    // Unpack bits...
+    if (type == prt::bit) {
+        for (const uint8_t &byte : bytes)
+            for (size_t k = 0u; k < 8u; ++k) v.push_back((byte >> k) & 1u);
+        return v;
+    }
 
-            // Exit if reaching the end of the file
-            if (!file.gcount()) break;
+    // ... or decode values of the right width
+    const size_t width = prt::bits(type) / 8u;
+    for (size_t i = 0u; i + width <= bytes.size(); i += width) {
 
-            // Store elements
-            v.push_back(x);
+        // Pointer to the value
+        const uint8_t *p = bytes.data() + i;
 
+        // Convert it back
+        switch (type) {
+            case prt::u8: v.push_back(*p); break;
+            case prt::u16: { uint16_t x; std::memcpy(&x, p, sizeof x); v.push_back(x); break; }
+            case prt::u32: { uint32_t x; std::memcpy(&x, p, sizeof x); v.push_back(x); break; }
+            case prt::f32: { float x; std::memcpy(&x, p, sizeof x); v.push_back(x); break; }
+            default: { double x; std::memcpy(&x, p, sizeof x); v.push_back(x); break; }
         }
     }
 
-    // Close the file
-    file.close();
-
     return v;
 
 }
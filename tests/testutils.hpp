@@ -8,13 +8,15 @@
 #include <functional>
 #include <fstream>
 #include <sstream>
+#include <iterator>
 #include <boost/test/unit_test.hpp>
+#include "../src/buffer.hpp"
 
 namespace tst
 {
 
     // Functions used in unit tests
-    std::vector<double> read(const std::string&);
+    std::vector<double> read(const std::string&, const prt::Type& = prt::f64, const bool& = false);
     std::string readtext(const std::string&);
     void write(const std::string&, const std::string&);
     void checkError(const std::function<void()>&, const std::string&);
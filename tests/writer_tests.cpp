@@ -0,0 +1,86 @@
+#define BOOST_TEST_DYNAMIC_LINK
+#define BOOST_TEST_MODULE Main
+
+// Here we test the background writer.
+
+#include "testutils.hpp"
+#include "../src/writer.hpp"
+#include <boost/test/unit_test.hpp>
+
+// Test that containers are written in order and emptied
+BOOST_AUTO_TEST_CASE(writerWritesInOrder) {
+
+    // Open a file
+    std::ofstream file("output.dat", std::ios::binary);
+
+    // Containers to write
+    std::vector<uint8_t> first = {1u, 2u};
+    std::vector<uint8_t> second = {3u};
+
+    // Create a writer
+    Writer writer;
+
+    // Hand them over
+    writer.write(file, first);
+    writer.write(file, second);
+
+    // Wait for the second one (the first one must be done by then)
+    writer.wait(second);
+
+    // Check that both have been emptied
+    BOOST_CHECK(first.empty());
+    BOOST_CHECK(second.empty());
+    BOOST_CHECK_EQUAL(writer.pending(), 0u);
+
+    // Close the file
+    file.close();
+
+    // Read the data back in
+    std::vector<double> values = tst::read("output.dat", prt::u8);
+
+    // Check them
+    BOOST_CHECK_EQUAL(values.size(), 3u);
+    BOOST_CHECK_EQUAL(values[0u], 1.0);
+    BOOST_CHECK_EQUAL(values[1u], 2.0);
+    BOOST_CHECK_EQUAL(values[2u], 3.0);
+
+    // Remove files
+    std::remove("output.dat");
+
+}
+
+// Test that the writer writes everything before it goes
+BOOST_AUTO_TEST_CASE(writerDrainsBeforeStopping) {
+
+    // Open two files
+    std::ofstream foo("foo.dat", std::ios::binary);
+    std::ofstream bar("bar.dat", std::ios::binary);
+
+    // Many containers to write
+    std::vector<std::vector<uint8_t> > data(100u, std::vector<uint8_t>(1000u, 1u));
+
+    {
+        // Create a writer
+        Writer writer;
+
+        // Hand the containers over (alternating between files)
+        for (size_t i = 0u; i < data.size(); ++i) writer.write(i % 2u ? bar : foo, data[i]);
+
+    }
+
+    // Check that they have all been emptied
+    for (const auto &values : data) BOOST_CHECK(values.empty());
+
+    // Close the files
+    foo.close();
+    bar.close();
+
+    // Check that everything made it to the files
+    BOOST_CHECK_EQUAL(tst::read("foo.dat", prt::u8).size(), 50000u);
+    BOOST_CHECK_EQUAL(tst::read("bar.dat", prt::u8).size(), 50000u);
+
+    // Remove files
+    std::remove("foo.dat");
+    std::remove("bar.dat");
+
+}